@@ -165,8 +165,10 @@ std::pair<size_t, size_t> longest_common_substring(const std::string& str1, cons
     if (str1.empty() || str2.empty()) {
         return {0, 0};
     }
-    auto curr = std::vector<size_t>(str2.size());
-    auto prev = std::vector<size_t>(str2.size());
+    // it is called for each result of a search, the buffers are kept by each thread to avoid reallocating them
+    static thread_local std::vector<size_t> curr, prev;
+    curr.assign(str2.size(), 0);
+    prev.assign(str2.size(), 0);
     size_t max_substr = 0;
     size_t position = 0;
 
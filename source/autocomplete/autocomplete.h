@@ -62,6 +62,21 @@ struct Compare {
 
 std::pair<size_t, size_t> longest_common_substring(const std::string&, const std::string&);
 
+/** lower_bound for a value that is expected close to first
+ *
+ * The step is doubled until the value is passed, then a binary search is done on the last step. It's cheaper
+ * than a plain binary search when the sorted ranges are walked together, as in the intersection of postings
+ */
+template <typename It, typename V>
+It gallop_lower_bound(It first, It last, const V& value) {
+    const auto size = last - first;
+    decltype(last - first) bound = 1;
+    while (bound < size && first[bound] < value) {
+        bound *= 2;
+    }
+    return std::lower_bound(first + bound / 2, first + std::min(bound, size), value);
+}
+
 using autocomplete_map = std::map<std::string, std::string, Compare>;
 /** Map de type Autocomplete
  *
@@ -238,55 +253,116 @@ struct Autocomplete {
         bool operator()(const std::pair<std::string, std::vector<T>>& b, const std::string& a) { return (b.first < a); }
     };
 
-    /** Retrouve toutes les positions des élements contenant le mot des mots qui commencent par token */
-    std::vector<T> match(const std::string& token, const std::vector<vec_elt>& vec_source) const {
+    /// the posting lists of the words of a dictionary, they point into the dictionary and are sorted
+    using Postings = std::vector<const std::vector<T>*>;
+
+    /** Retrouve les listes des élements contenant un mot qui commence par token, sans les copier */
+    Postings match_postings(const std::string& token, const std::vector<vec_elt>& vec_source) const {
         // Les éléments dans vec_map sont triés par ordre alphabétiques, il suffit donc de trouver la borne inf et sup
         auto lower = std::lower_bound(vec_source.begin(), vec_source.end(), token, comp());
-        auto upper = std::upper_bound(vec_source.begin(), vec_source.end(), token, comp());
+        auto upper = std::upper_bound(lower, vec_source.end(), token, comp());
 
-        std::vector<T> result;
+        Postings postings;
+        postings.reserve(upper - lower);
+        for (; lower != upper; ++lower) {
+            postings.push_back(&lower->second);
+        }
+        return postings;
+    }
+
+    /** Retrouve toutes les positions des élements contenant le mot des mots qui commencent par token */
+    std::vector<T> match(const std::string& token, const std::vector<vec_elt>& vec_source) const {
+        const auto postings = match_postings(token, vec_source);
+        size_t nb_elements = 0;
+        for (const auto* posting : postings) {
+            nb_elements += posting->size();
+        }
 
         // On concatène tous les indexes
         // Pour les raisons de perfs mesurées expérimentalement, on accepte des doublons
-        for (; lower != upper; ++lower) {
-            std::vector<T> other = lower->second;
-            result.insert(result.end(), other.begin(), other.end());
+        std::vector<T> result;
+        result.reserve(nb_elements);
+        for (const auto* posting : postings) {
+            result.insert(result.end(), posting->begin(), posting->end());
         }
         return result;
     }
 
+    /** Flag the candidates that are in the posting
+     *
+     * Both are sorted without duplicates: the shortest one is walked and the other one is searched by galloping
+     */
+    static void flag_found(const std::vector<T>& candidates, const std::vector<T>& posting, std::vector<bool>& found) {
+        if (posting.size() < candidates.size()) {
+            auto it = candidates.begin();
+            for (const auto& elt : posting) {
+                it = gallop_lower_bound(it, candidates.end(), elt);
+                if (it == candidates.end()) {
+                    return;
+                }
+                if (*it == elt) {
+                    found[it - candidates.begin()] = true;
+                }
+            }
+        } else {
+            auto it = posting.begin();
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                it = gallop_lower_bound(it, posting.end(), candidates[i]);
+                if (it == posting.end()) {
+                    return;
+                }
+                if (*it == candidates[i]) {
+                    found[i] = true;
+                }
+            }
+        }
+    }
+
     /** On passe une chaîne de charactère contenant des mots et on trouve toutes les positions contenant tous ces mots*/
     std::vector<T> find(const std::set<std::string>& vecStr) const {
-        std::vector<T> result;
-        auto vec = vecStr.begin();
-        if (vec != vecStr.end()) {
-            // Premier résultat. Il y aura au plus ces indexes
-            result = match(*vec, word_dictionnary);
-
-            // If there is only one word to search we have to sort and delete duplicate results
-            if (vecStr.size() == 1) {
-                std::sort(result.begin(), result.end());
-                result.erase(unique(result.begin(), result.end()), result.end());
+        if (vecStr.empty()) {
+            return {};
+        }
+        // the words are intersected from the one with the fewest elements, to keep the candidates as few as possible
+        std::vector<std::pair<size_t, Postings>> postings_by_word;
+        postings_by_word.reserve(vecStr.size());
+        for (const auto& word : vecStr) {
+            auto postings = match_postings(word, word_dictionnary);
+            size_t nb_elements = 0;
+            for (const auto* posting : postings) {
+                nb_elements += posting->size();
             }
+            postings_by_word.emplace_back(nb_elements, std::move(postings));
+        }
+        std::sort(postings_by_word.begin(), postings_by_word.end(),
+                  [](const std::pair<size_t, Postings>& a, const std::pair<size_t, Postings>& b) {
+                      return a.first < b.first;
+                  });
 
-            for (++vec; vec != vecStr.end(); ++vec) {
-                std::vector<T> new_result;
-                std::sort(result.begin(), result.end());
-                for (auto i : match(*vec, word_dictionnary)) {
-                    // Binary search fait une recherche dichotomique pour savoir si l'élément i existe
-                    // S'il existe dans les deux cas, on le garde
-                    if (binary_search(result.begin(), result.end(), i)) {
-                        new_result.push_back(i);
-                    }
+        // Premier résultat. Il y aura au plus ces indexes
+        std::vector<T> result;
+        result.reserve(postings_by_word.front().first);
+        for (const auto* posting : postings_by_word.front().second) {
+            result.insert(result.end(), posting->begin(), posting->end());
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+
+        std::vector<bool> found;
+        for (auto word = std::next(postings_by_word.begin()); word != postings_by_word.end() && !result.empty();
+             ++word) {
+            // an element is kept if it is in one of the postings of the word
+            found.assign(result.size(), false);
+            for (const auto* posting : word->second) {
+                flag_found(result, *posting, found);
+            }
+            size_t nb_kept = 0;
+            for (size_t i = 0; i < result.size(); ++i) {
+                if (found[i]) {
+                    result[nb_kept++] = result[i];
                 }
-                // The function "unique" works only if the vector new_result is sorted.
-                std::sort(new_result.begin(), new_result.end());
-
-                // std::unique retrie les donnée et fout les doublons à la fin
-                // La fonction retourne un itérateur vers le premier doublon
-                // Expérimentalement le gain est très faible
-                result.assign(new_result.begin(), std::unique(new_result.begin(), new_result.end()));
             }
+            result.resize(nb_kept);
         }
         return result;
     }
@@ -329,14 +405,14 @@ struct Autocomplete {
      *     that will match the 'RER B' query, but is less relevant that the "RER B" object :)
      *
      * the scores are compared lexicographicaly
-     * @param str: string to search
+     * @param stripped_str: string to search, already given to strip_accents_and_lower
      * @param position: element to score
      */
-    std::tuple<int, size_t, int> compute_result_scores(const std::string& str, T position) const {
+    std::tuple<int, size_t, int> compute_result_scores(const std::string& stripped_str, T position) const {
         auto global_score = word_quality_list.at(position).score;
 
         const auto& indexed_str = indexed_string.at(position);
-        auto lcs_and_pos = longest_common_substring(strip_accents_and_lower(str), indexed_str);
+        auto lcs_and_pos = longest_common_substring(stripped_str, indexed_str);
 
         return std::make_tuple(global_score, lcs_and_pos.first,
                                -1 * lcs_and_pos.second  // we want to minimize the position
@@ -360,12 +436,13 @@ struct Autocomplete {
         // Créer un vector de réponse:
         std::vector<fl_quality> vec_quality;
 
+        const auto stripped_str = strip_accents_and_lower(str);
         for (auto i : index_result) {
             if (keep_element(i)) {
                 quality.idx = i;
                 quality.nb_found = word_quality_list.at(quality.idx).word_count;
                 quality.word_len = wordLength;
-                quality.scores = this->compute_result_scores(str, quality.idx);
+                quality.scores = this->compute_result_scores(stripped_str, quality.idx);
 
                 quality.quality = 100;
                 vec_quality.push_back(quality);
@@ -430,13 +507,14 @@ struct Autocomplete {
             }
 
             // Here we keep object with match of patternized words >= 75%
-            for (auto pair : fl_result) {
+            const auto stripped_str = strip_accents_and_lower(str);
+            for (const auto& pair : fl_result) {
                 if (keep_element(pair.first)
                     && (((pattern_count - pair.second.nb_found) * 100) / pattern_count <= 25)) {
                     quality.idx = pair.first;
                     quality.nb_found = pair.second.nb_found;
                     quality.word_len = wordLength;
-                    quality.scores = this->compute_result_scores(str, quality.idx);
+                    quality.scores = this->compute_result_scores(stripped_str, quality.idx);
                     quality.quality = calc_quality_pattern(quality, word_weight, max_score, pattern_count);
                     vec_quality.push_back(quality);
                 }
@@ -173,7 +173,7 @@ static void update_quality(std::vector<Autocomplete<nt::idx_t>::fl_quality>& ac_
 static std::unordered_set<std::string> get_main_stop_areas(const navitia::type::Data& d) {
     std::unordered_set<std::string> result;
     for (const auto& admin : d.geo_ref->admins) {
-        for (const auto& sa : admin->main_stop_areas) {
+        for (const auto& sa : d.pt_data->main_stop_areas(*admin)) {
             result.insert(sa->uri);
         }
     }
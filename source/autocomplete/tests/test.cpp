@@ -133,6 +133,33 @@ BOOST_AUTO_TEST_CASE(parse_find_with_synonym_and_synonyms_test) {
     BOOST_CHECK_EQUAL(res5.at(0).quality, 100);
 }
 
+// find keeps the elements matching all the words, each word matching the prefix of any indexed word
+BOOST_AUTO_TEST_CASE(find_intersects_the_postings_of_the_words) {
+    autocomplete_map synonyms;
+    std::set<std::string> ghostwords;
+
+    Autocomplete<unsigned int> ac;
+    ac.add_string("rue jean jaures", 0, ghostwords, synonyms);
+    ac.add_string("rue jeanne d'arc", 1, ghostwords, synonyms);
+    ac.add_string("avenue jean jaures", 2, ghostwords, synonyms);
+    ac.add_string("rue de la jeunesse", 3, ghostwords, synonyms);
+    ac.add_string("place jean moulin", 4, ghostwords, synonyms);
+    for (unsigned int i = 5; i < 100; ++i) {
+        ac.add_string("rue " + std::to_string(i), i, ghostwords, synonyms);
+    }
+    ac.build();
+
+    using Result = std::vector<unsigned int>;
+    BOOST_CHECK(ac.find({}) == Result());
+    BOOST_CHECK(ac.find({"jean"}) == Result({0, 1, 2, 4}));
+    BOOST_CHECK(ac.find({"rue", "jean"}) == Result({0, 1}));
+    BOOST_CHECK(ac.find({"rue", "je"}) == Result({0, 1, 3}));
+    BOOST_CHECK(ac.find({"jaures", "jean", "rue"}) == Result({0}));
+    BOOST_CHECK(ac.find({"rue", "9"}) == Result({9, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99}));
+    BOOST_CHECK(ac.find({"rue", "moulin"}) == Result());
+    BOOST_CHECK(ac.find({"rue", "unknown"}) == Result());
+}
+
 BOOST_AUTO_TEST_CASE(regex_tests) {
     boost::regex re("\\<c c\\>");
     BOOST_CHECK(boost::regex_search("c c", re));
@@ -638,7 +665,7 @@ BOOST_AUTO_TEST_CASE(autocomplete_main_stop_area_test) {
     ad->postal_codes.push_back("29000");
     ad->idx = 0;
     b.data->geo_ref->admins.push_back(ad);
-    ad->main_stop_areas.push_back(b.data->pt_data->stop_areas_map["Luther King"]);
+    b.data->pt_data->main_stop_areas_by_admin[ad->idx].push_back(b.data->pt_data->stop_areas_map["Luther King"]);
     b.manage_admin();
     b.build_autocomplete();
 
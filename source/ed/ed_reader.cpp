@@ -38,12 +38,15 @@ www.navitia.io
 #include "type/contributor.h"
 #include "type/commercial_mode.h"
 #include "type/dataset.h"
+#include "utils/timer.h"
 
 #include <boost/foreach.hpp>
 #include <boost/geometry.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/smart_ptr/shared_ptr.hpp>
+
+#include <functional>
 namespace ed {
 
 namespace bg = boost::gregorian;
@@ -61,94 +64,171 @@ static void release(T& a) {
     a.swap(b);
 }
 
+static const std::string admin_request =
+    "SELECT id, name, uri, comment, insee, level, ST_X(coord::geometry) as lon, "
+    "ST_Y(coord::geometry) as lat, ST_asText(boundary) as boundary "
+    "FROM georef.admin";
+
+static const std::string poi_request =
+    "SELECT poi.id, poi.weight, ST_X(poi.coord::geometry) as lon, "
+    "ST_Y(poi.coord::geometry) as lat, poi.visible as visible, "
+    "poi.name, poi.uri, poi.poi_type_id, poi.address_number, "
+    "poi.address_name FROM georef.poi poi, "
+    "georef.poi_type poi_type where poi.poi_type_id=poi_type.id;";
+
+static const std::string way_request = "SELECT id, name, uri, type, visible FROM georef.way;";
+
+static const std::string house_number_request =
+    "SELECT way_id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat, number, left_side FROM "
+    "georef.house_number where way_id IS NOT NULL;";
+
+static const std::string vertex_request =
+    "select id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat from georef.node;";
+
+static std::string graph_request(bool export_georef_edges_geometries) {
+    std::string request =
+        "select e.source_node_id, target_node_id, e.way_id, "
+        "ST_LENGTH(the_geog) AS leng, e.pedestrian_allowed as pede, "
+        "e.cycles_allowed as bike,e.cars_allowed as car, car_speed";
+    // Don't call ST_ASTEXT if not needed since it's slow
+    if (export_georef_edges_geometries) {
+        request += ", ST_ASTEXT(the_geog) AS geometry";
+    }
+    request += " from georef.edge e;";
+    return request;
+}
+
+void EdReader::prefetch(const std::string& request) {
+    const auto& conn_str = connection_string;
+    prefetched_results[request] = std::async(std::launch::async, [conn_str, request]() {
+        pqxx::connection prefetch_conn(conn_str);
+        pqxx::read_transaction work(prefetch_conn, "prefetching ED");
+        return work.exec(request);
+    });
+}
+
+pqxx::result EdReader::exec(pqxx::work& work, const std::string& request) {
+    auto it = prefetched_results.find(request);
+    if (it == prefetched_results.end()) {
+        return work.exec(request);
+    }
+    auto result = it->second.get();
+    prefetched_results.erase(it);
+    return result;
+}
+
 void EdReader::fill(navitia::type::Data& data,
                     const double min_non_connected_graph_ratio,
                     const bool export_georef_edges_geometries) {
+    // the georef tables are the biggest ones and don't depend on the transit ones,
+    // we read them on other connections while the transit tables are loaded
+    for (const auto& request : {admin_request, poi_request, way_request, house_number_request, vertex_request,
+                                graph_request(export_georef_edges_geometries)}) {
+        prefetch(request);
+    }
+
     pqxx::work work(*conn, "loading ED");
 
-    this->fill_vector_to_ignore(work, min_non_connected_graph_ratio);
-    this->fill_meta(data, work);
-    // TODO merge fill_feed_infos, fill_meta
-    this->fill_feed_infos(data, work);
-    this->fill_timezones(data, work);
-    this->fill_networks(data, work);
-    this->fill_commercial_modes(data, work);
-    this->fill_physical_modes(data, work);
-    this->fill_companies(data, work);
-    this->fill_contributors(data, work);
-    this->fill_datasets(data, work);
-
-    this->fill_stop_areas(data, work);
-    this->fill_stop_points(data, work);
-    this->fill_access_points(data, work);
-    this->fill_ntfs_addresses(work);
-
-    this->fill_lines(data, work);
-    this->fill_line_groups(data, work);
-    this->fill_routes(data, work);
-    this->fill_validity_patterns(data, work);
-
-    // the comments are loaded before the stop time (and thus the vj)
-    // to reduce the memory foot print
-    this->fill_comments(data, work);
-    // the stop times are loaded before the vj as create_vj need the
-    // list of stop times
-    this->fill_shapes(data, work);
-    this->fill_stop_times(data, work);
-    this->fill_vehicle_journeys(data, work);
-    this->finish_stop_times(data);
-
-    /// grid calendar
-    this->fill_calendars(data, work);
-    this->fill_periods(data, work);
-    this->fill_exception_dates(data, work);
-    this->fill_rel_calendars_lines(data, work);
-
-    /// meta vj associated calendars
-    this->fill_associated_calendar(data, work);
-    this->fill_meta_vehicle_journeys(data, work);
-
-    this->fill_admins(data, work);
-    this->fill_admins_postal_codes(data, work);
-    this->fill_admin_stop_areas(data, work);
-    this->fill_object_codes(data, work);
-
-    //@TODO: les connections ont des doublons, en attendant que ce soit corrigé, on ne les enregistre pas
-    this->fill_stop_point_connections(data, work);
-    this->fill_poi_types(data, work);
-    this->fill_pois(data, work);
-    this->fill_poi_properties(data, work);
-    this->fill_ways(data, work);
-    this->fill_house_numbers(data, work);
-    this->fill_vertex(data, work);
-    this->fill_graph(data, work, export_georef_edges_geometries);
-
-    // we need the proximity_list to build bss and parking edges
-    data.geo_ref->build_proximity_list();
-    this->fill_graph_bss(data, work);
-    this->fill_graph_parking(data, work);
-
-    // Charger les synonymes
-    this->fill_synonyms(data, work);
-
-    /// les relations admin et les autres objets
-    this->build_rel_way_admin(data, work);
-    this->build_rel_admin_admin(data, work);
-
-    this->fill_prices(data, work);
-    this->fill_transitions(data, work);
-    this->fill_origin_destinations(data, work);
+    auto stage = [&](const std::string& name, const std::function<void()>& fill_stage) {
+        Timer timer(name, false);
+        fill_stage();
+        LOG4CPLUS_INFO(log, "\t " << name << ": " << timer.ms() << "ms");
+    };
+
+    stage("graph components", [&] { this->fill_vector_to_ignore(work, min_non_connected_graph_ratio); });
+    stage("referentials", [&] {
+        this->fill_meta(data, work);
+        // TODO merge fill_feed_infos, fill_meta
+        this->fill_feed_infos(data, work);
+        this->fill_timezones(data, work);
+        this->fill_networks(data, work);
+        this->fill_commercial_modes(data, work);
+        this->fill_physical_modes(data, work);
+        this->fill_companies(data, work);
+        this->fill_contributors(data, work);
+        this->fill_datasets(data, work);
+    });
+
+    stage("stops", [&] {
+        this->fill_stop_areas(data, work);
+        this->fill_stop_points(data, work);
+        this->fill_access_points(data, work);
+        this->fill_ntfs_addresses(work);
+    });
+
+    stage("lines and routes", [&] {
+        this->fill_lines(data, work);
+        this->fill_line_groups(data, work);
+        this->fill_routes(data, work);
+        this->fill_validity_patterns(data, work);
+    });
+
+    stage("vehicle journeys", [&] {
+        // the comments are loaded before the stop time (and thus the vj)
+        // to reduce the memory foot print
+        this->fill_comments(data, work);
+        // the stop times are loaded before the vj as create_vj need the
+        // list of stop times
+        this->fill_shapes(data, work);
+        this->fill_stop_times(data, work);
+        this->fill_vehicle_journeys(data, work);
+        this->finish_stop_times(data);
+    });
+
+    stage("calendars", [&] {
+        /// grid calendar
+        this->fill_calendars(data, work);
+        this->fill_periods(data, work);
+        this->fill_exception_dates(data, work);
+        this->fill_rel_calendars_lines(data, work);
+
+        /// meta vj associated calendars
+        this->fill_associated_calendar(data, work);
+        this->fill_meta_vehicle_journeys(data, work);
+    });
+
+    stage("admins", [&] {
+        this->fill_admins(data, work);
+        this->fill_admins_postal_codes(data, work);
+        this->fill_admin_stop_areas(data, work);
+        this->fill_object_codes(data, work);
+    });
+
+    stage("georef", [&] {
+        //@TODO: les connections ont des doublons, en attendant que ce soit corrigé, on ne les enregistre pas
+        this->fill_stop_point_connections(data, work);
+        this->fill_poi_types(data, work);
+        this->fill_pois(data, work);
+        this->fill_poi_properties(data, work);
+        this->fill_ways(data, work);
+        this->fill_house_numbers(data, work);
+        this->fill_vertex(data, work);
+        this->fill_graph(data, work, export_georef_edges_geometries);
+
+        // we need the proximity_list to build bss and parking edges
+        data.geo_ref->build_proximity_list();
+        this->fill_graph_bss(data, work);
+        this->fill_graph_parking(data, work);
+
+        // Charger les synonymes
+        this->fill_synonyms(data, work);
+
+        /// les relations admin et les autres objets
+        this->build_rel_way_admin(data, work);
+        this->build_rel_admin_admin(data, work);
+    });
+
+    stage("fares", [&] {
+        this->fill_prices(data, work);
+        this->fill_transitions(data, work);
+        this->fill_origin_destinations(data, work);
+    });
 
     check_coherence(data);
 }
 
 void EdReader::fill_admins(navitia::type::Data& nav_data, pqxx::work& work) {
-    std::string request =
-        "SELECT id, name, uri, comment, insee, level, ST_X(coord::geometry) as lon, "
-        "ST_Y(coord::geometry) as lat, ST_asText(boundary) as boundary "
-        "FROM georef.admin";
-
-    pqxx::result result = work.exec(request);
+    pqxx::result result = exec(work, admin_request);
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
         auto* admin = new navitia::georef::Admin;
         const_it["comment"].to(admin->comment);
@@ -191,7 +271,7 @@ void EdReader::fill_admins_postal_codes(navitia::type::Data& /*unused*/, pqxx::w
     }
 }
 
-void EdReader::fill_admin_stop_areas(navitia::type::Data& /*unused*/, pqxx::work& work) {
+void EdReader::fill_admin_stop_areas(navitia::type::Data& data, pqxx::work& work) {
     std::string request = "SELECT admin_id, stop_area_id from navitia.admin_stop_area";
 
     size_t nb_unknown_admin(0), nb_unknown_stop(0), nb_valid_admin(0);
@@ -219,7 +299,7 @@ void EdReader::fill_admin_stop_areas(navitia::type::Data& /*unused*/, pqxx::work
 
         navitia::type::StopArea* sa = it_sa->second;
 
-        admin->main_stop_areas.push_back(sa);
+        data.pt_data->main_stop_areas_by_admin[admin->idx].push_back(sa);
         nb_valid_admin++;
     }
     LOG4CPLUS_INFO(log, nb_valid_admin << " admin with at least one main stop");
@@ -1403,13 +1483,7 @@ void EdReader::fill_poi_types(navitia::type::Data& data, pqxx::work& work) {
 }
 
 void EdReader::fill_pois(navitia::type::Data& data, pqxx::work& work) {
-    std::string request =
-        "SELECT poi.id, poi.weight, ST_X(poi.coord::geometry) as lon, "
-        "ST_Y(poi.coord::geometry) as lat, poi.visible as visible, "
-        "poi.name, poi.uri, poi.poi_type_id, poi.address_number, "
-        "poi.address_name FROM georef.poi poi, "
-        "georef.poi_type poi_type where poi.poi_type_id=poi_type.id;";
-    pqxx::result result = work.exec(request);
+    pqxx::result result = exec(work, poi_request);
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
         std::string string_number;
         int int_number;
@@ -1451,8 +1525,7 @@ void EdReader::fill_poi_properties(navitia::type::Data& /*unused*/, pqxx::work&
 }
 
 void EdReader::fill_ways(navitia::type::Data& data, pqxx::work& work) {
-    std::string request = "SELECT id, name, uri, type, visible FROM georef.way;";
-    pqxx::result result = work.exec(request);
+    pqxx::result result = exec(work, way_request);
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
         auto id = const_it["id"].as<idx_t>();
 
@@ -1473,10 +1546,7 @@ void EdReader::fill_ways(navitia::type::Data& data, pqxx::work& work) {
 }
 
 void EdReader::fill_house_numbers(navitia::type::Data& data, pqxx::work& work) {
-    std::string request =
-        "SELECT way_id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat, number, left_side FROM "
-        "georef.house_number where way_id IS NOT NULL;";
-    pqxx::result result = work.exec(request);
+    pqxx::result result = exec(work, house_number_request);
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
         std::string string_number;
         const_it["number"].to(string_number);
@@ -1638,8 +1708,7 @@ void EdReader::fill_vector_to_ignore(pqxx::work& work, const double min_non_conn
 }
 
 void EdReader::fill_vertex(navitia::type::Data& data, pqxx::work& work) {
-    std::string request = "select id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat from georef.node;";
-    pqxx::result result = work.exec(request);
+    pqxx::result result = exec(work, vertex_request);
     uint64_t idx = 0;
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
         auto id = const_it["id"].as<uint64_t>();
@@ -1690,16 +1759,7 @@ boost::optional<navitia::time_res_traits::sec_type> EdReader::get_duration(nt::M
 }
 
 void EdReader::fill_graph(navitia::type::Data& data, pqxx::work& work, bool export_georef_edges_geometries) {
-    std::string request =
-        "select e.source_node_id, target_node_id, e.way_id, "
-        "ST_LENGTH(the_geog) AS leng, e.pedestrian_allowed as pede, "
-        "e.cycles_allowed as bike,e.cars_allowed as car, car_speed";
-    // Don't call ST_ASTEXT if not needed since it's slow
-    if (export_georef_edges_geometries) {
-        request += ", ST_ASTEXT(the_geog) AS geometry";
-    }
-    request += " from georef.edge e;";
-    pqxx::result result = work.exec(request);
+    pqxx::result result = exec(work, graph_request(export_georef_edges_geometries));
     size_t nb_edges_no_way = 0, nb_useless_edges = 0;
     size_t nb_walking_edges(0), nb_biking_edges(0), nb_driving_edges(0);
 
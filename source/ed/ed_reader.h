@@ -36,6 +36,7 @@ www.navitia.io
 
 #include <boost/graph/strong_components.hpp>
 #include <boost/graph/connected_components.hpp>
+#include <future>
 #include <memory>
 
 #include <pqxx/pqxx>
@@ -47,8 +48,10 @@ namespace ed {
 
 struct EdReader {
     std::unique_ptr<pqxx::connection> conn;
+    // used to open the connections of the prefetched requests
+    std::string connection_string;
 
-    EdReader(const std::string& connection_string) {
+    EdReader(const std::string& connection_string) : connection_string(connection_string) {
         try {
             conn = std::make_unique<pqxx::connection>(connection_string);
         } catch (const pqxx::pqxx_exception& e) {
@@ -112,6 +115,13 @@ private:
     using EdgeId = std::pair<uint64_t, uint64_t>;
     navitia::flat_enum_map<navitia::type::Mode_e, std::set<EdgeId>> edge_to_ignore_by_modes;
 
+    // the biggest georef requests are run on their own connection while the transit tables are read,
+    // the results are indexed by their request
+    std::unordered_map<std::string, std::future<pqxx::result>> prefetched_results;
+    void prefetch(const std::string& request);
+    // return the prefetched result of the request if any, else run it in work
+    pqxx::result exec(pqxx::work& work, const std::string& request);
+
     void fill_meta(navitia::type::Data& nav_data, pqxx::work& work);
     void fill_feed_infos(navitia::type::Data& data, pqxx::work& work);
     void fill_timezones(navitia::type::Data& data, pqxx::work& work);
@@ -47,8 +47,11 @@ www.navitia.io
 #include <boost/range/algorithm/reverse.hpp>
 
 #include <cstdio>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <queue>
+#include <thread>
 #include <utility>
 
 namespace po = boost::program_options;
@@ -247,6 +250,20 @@ void OSMCache::build_relations_geometries() {
  * Find the admin of coordinates
  */
 const Admin* OSMCache::match_coord_admin(const double lon, const double lat) {
+    if (const auto* admin = match_coord_admin_in_tree(lon, lat)) {
+        return admin;
+    }
+    if (this->cities_db) {
+        return find_admin_in_cities(lon, lat);
+    }
+    return nullptr;
+}
+
+/*
+ * Find the admin of coordinates among the admins already loaded.
+ * It only reads the admin tree so it can be called by several threads
+ */
+const Admin* OSMCache::match_coord_admin_in_tree(const double lon, const double lat) {
     Rect search_rect(lon, lat);
     const auto p = point(lon, lat);
     using Admins = std::vector<const Admin*>;
@@ -265,9 +282,6 @@ const Admin* OSMCache::match_coord_admin(const double lon, const double lat) {
             return rel;
         }
     }
-    if (this->cities_db) {
-        return find_admin_in_cities(lon, lat);
-    }
     return nullptr;
 }
 
@@ -331,14 +345,51 @@ const Admin* OSMCache::find_admin_in_cities(const double lon, const double lat)
  */
 void OSMCache::match_nodes_admin() {
     auto logger = log4cplus::Logger::getInstance("log");
-    size_t count_matches = 0;
+    std::vector<const OSMNode*> to_match;
     for (const auto& node : nodes) {
-        if (!node.is_defined() || node.admin) {
-            continue;
+        if (node.is_defined() && !node.admin) {
+            to_match.push_back(&node);
         }
-        node.admin = match_coord_admin(node.lon(), node.lat());
-        if (node.admin != nullptr) {
-            ++count_matches;
+    }
+
+    // the nodes are first matched against the admin tree by batches, each thread takes every
+    // nb_threads-th batch and only writes the admin of its nodes
+    const size_t nb_batches = nb_threads * 4;
+    const size_t batch_size = to_match.size() / nb_batches + 1;
+    auto match_batches = [&](const size_t first_batch) {
+        size_t count = 0;
+        for (size_t batch = first_batch; batch < nb_batches; batch += nb_threads) {
+            const auto begin = std::min(batch * batch_size, to_match.size());
+            const auto end = std::min(begin + batch_size, to_match.size());
+            for (auto i = begin; i < end; ++i) {
+                const auto* node = to_match[i];
+                node->admin = match_coord_admin_in_tree(node->lon(), node->lat());
+                if (node->admin != nullptr) {
+                    ++count;
+                }
+            }
+        }
+        return count;
+    };
+    std::vector<std::future<size_t>> workers;
+    for (size_t i = 1; i < nb_threads; ++i) {
+        workers.push_back(std::async(std::launch::async, match_batches, i));
+    }
+    size_t count_matches = match_batches(0);
+    for (auto& worker : workers) {
+        count_matches += worker.get();
+    }
+
+    // the remaining nodes are searched in the cities database, this fills the admin tree so it stays sequential
+    if (this->cities_db) {
+        for (const auto* node : to_match) {
+            if (node->admin) {
+                continue;
+            }
+            node->admin = match_coord_admin(node->lon(), node->lat());
+            if (node->admin != nullptr) {
+                ++count_matches;
+            }
         }
     }
 
@@ -409,32 +460,26 @@ void OSMCache::insert_ways() {
     LOG4CPLUS_INFO(logger, n_inserted << "/" << ways.size() << " ways inserted");
 }
 
+using EdgeRows = std::vector<std::vector<std::string>>;
+
 /*
- * Insert edges of the streetnetwork graph into the database.
- * For that we read ways, if a node of a way is used several times it's a node
- * of the streetnetwork graph, so there's a new edge between the last node and
- * this node.
+ * Build the rows of the edges of a batch of ways.
+ * If a node of a way is used several times it's a node of the streetnetwork graph,
+ * so there's a new edge between the last node and this node.
  */
-void OSMCache::insert_edges() {
-    auto logger = log4cplus::Logger::getInstance("log");
-    if (!this->lotus) {
-        LOG4CPLUS_INFO(logger, "no database to insert edges");
-        return;
-    }
-
-    this->lotus->prepare_bulk_insert("georef.edge",
-                                     {"source_node_id", "target_node_id", "way_id", "the_geog", "pedestrian_allowed",
-                                      "cycles_allowed", "cars_allowed", "car_speed"});
+static EdgeRows build_edge_rows(const std::vector<it_way>& ways,
+                                const std::set<OSMNode>::const_iterator no_node,
+                                const std::string& null_value) {
+    EdgeRows rows;
     nt::LineString coords;
     std::stringstream wkt;
     wkt.precision(10);
-    size_t n_inserted = 0;
-    const size_t max_n_inserted = 20000;
-    for (const auto& way : ways) {
-        auto prev_node = nodes.end();
+    for (const auto& way_it : ways) {
+        const auto& way = *way_it;
+        auto prev_node = no_node;
         const auto ref_way_id = way.way_ref == nullptr ? way.osm_id : way.way_ref->osm_id;
 
-        std::string speed = lotus->null_value;
+        std::string speed = null_value;
         if (way.car_speed) {
             speed = std::to_string(way.car_speed.get());
         }
@@ -442,8 +487,8 @@ void OSMCache::insert_edges() {
             if (!node->is_defined()) {
                 continue;
             }
-            if ((node->is_used_more_than_once() && prev_node != nodes.end())
-                || (node == way.nodes.back() && prev_node != nodes.end())) {
+            if ((node->is_used_more_than_once() && prev_node != no_node)
+                || (node == way.nodes.back() && prev_node != no_node)) {
                 // If a node is used more than once, it is an intersection,
                 // hence it's a node of the street network graph
                 // If a node is only used by one way we can simplify the and reduce the number of edges, we don't need
@@ -452,37 +497,87 @@ void OSMCache::insert_edges() {
                 coords.push_back({node->lon(), node->lat()});
                 wkt.str("");
                 wkt << boost::geometry::wkt(coords);
-                this->lotus->insert({std::to_string(prev_node->osm_id), std::to_string(node->osm_id),
-                                     std::to_string(ref_way_id), wkt.str(),
-                                     std::to_string(way.properties[OSMWay::FOOT_FWD]),
-                                     std::to_string(way.properties[OSMWay::CYCLE_FWD]),
-                                     std::to_string(way.properties[OSMWay::CAR_FWD]), speed});
+                rows.push_back({std::to_string(prev_node->osm_id), std::to_string(node->osm_id),
+                                std::to_string(ref_way_id), wkt.str(), std::to_string(way.properties[OSMWay::FOOT_FWD]),
+                                std::to_string(way.properties[OSMWay::CYCLE_FWD]),
+                                std::to_string(way.properties[OSMWay::CAR_FWD]), speed});
                 // In most of the case we need the reversal,
                 // that'll be wrong for some in case in car
                 // We need to work on it
                 std::reverse(coords.begin(), coords.end());
                 wkt.str("");
                 wkt << boost::geometry::wkt(coords);
-                this->lotus->insert({std::to_string(node->osm_id), std::to_string(prev_node->osm_id),
-                                     std::to_string(ref_way_id), wkt.str(),
-                                     std::to_string(way.properties[OSMWay::FOOT_BWD]),
-                                     std::to_string(way.properties[OSMWay::CYCLE_BWD]),
-                                     std::to_string(way.properties[OSMWay::CAR_BWD]), speed});
-                prev_node = nodes.end();
-                n_inserted = n_inserted + 2;
+                rows.push_back({std::to_string(node->osm_id), std::to_string(prev_node->osm_id),
+                                std::to_string(ref_way_id), wkt.str(), std::to_string(way.properties[OSMWay::FOOT_BWD]),
+                                std::to_string(way.properties[OSMWay::CYCLE_BWD]),
+                                std::to_string(way.properties[OSMWay::CAR_BWD]), speed});
+                prev_node = no_node;
             }
-            if (prev_node == nodes.end()) {
+            if (prev_node == no_node) {
                 coords.clear();
                 prev_node = node;
             }
             coords.push_back({node->lon(), node->lat()});
         }
-        if ((n_inserted % max_n_inserted) == 0) {
+    }
+    return rows;
+}
+
+/*
+ * Insert edges of the streetnetwork graph into the database.
+ * The rows of the next batches of ways are built by nb_threads threads while the
+ * current batch is sent to the database.
+ */
+void OSMCache::insert_edges() {
+    auto logger = log4cplus::Logger::getInstance("log");
+    if (!this->lotus) {
+        LOG4CPLUS_INFO(logger, "no database to insert edges");
+        return;
+    }
+
+    const size_t nb_ways_by_batch = 10000;
+    std::vector<std::vector<it_way>> batches;
+    for (auto it = ways.begin(); it != ways.end(); ++it) {
+        if (batches.empty() || batches.back().size() == nb_ways_by_batch) {
+            batches.emplace_back();
+            batches.back().reserve(nb_ways_by_batch);
+        }
+        batches.back().push_back(it);
+    }
+
+    const std::string null_value = lotus->null_value;
+    std::deque<std::future<EdgeRows>> pending;
+    size_t next_batch = 0;
+    auto build_next_batch = [&]() {
+        pending.push_back(std::async(std::launch::async, build_edge_rows, std::cref(batches[next_batch]),
+                                     nodes.cend(), std::cref(null_value)));
+        ++next_batch;
+    };
+    while (pending.size() < nb_threads && next_batch < batches.size()) {
+        build_next_batch();
+    }
+
+    const std::vector<std::string> columns = {"source_node_id", "target_node_id", "way_id",       "the_geog",
+                                              "pedestrian_allowed", "cycles_allowed", "cars_allowed", "car_speed"};
+    this->lotus->prepare_bulk_insert("georef.edge", columns);
+    size_t n_inserted = 0, n_in_bulk = 0;
+    const size_t max_n_inserted = 20000;
+    while (!pending.empty()) {
+        const auto rows = pending.front().get();
+        pending.pop_front();
+        if (next_batch < batches.size()) {
+            build_next_batch();
+        }
+        for (const auto& row : rows) {
+            this->lotus->insert(row);
+            ++n_inserted;
+            ++n_in_bulk;
+        }
+        if (n_in_bulk >= max_n_inserted) {
             this->lotus->finish_bulk_insert();
             LOG4CPLUS_INFO(logger, n_inserted << " edges inserted");
-            this->lotus->prepare_bulk_insert(
-                "georef.edge", {"source_node_id", "target_node_id", "way_id", "the_geog", "pedestrian_allowed",
-                                "cycles_allowed", "cars_allowed", "car_speed"});
+            this->lotus->prepare_bulk_insert("georef.edge", columns);
+            n_in_bulk = 0;
         }
     }
     this->lotus->finish_bulk_insert();
@@ -1119,6 +1214,7 @@ void OSMCache::flag_nodes() {
 int osm2ed(int argc, const char** argv) {
     pt::ptime start;
     std::string input, connection_string, json_poi_types;
+    size_t nb_threads;
 
     po::options_description desc("Allowed options");
 
@@ -1138,7 +1234,9 @@ int osm2ed(int argc, const char** argv) {
         ("log_comment", po::value<std::string>(), "optional field to add extra information like coverage name")
         ("cities-connection-string", po::value<std::string>(),
             "cities database connection string, to use admins from cities instead of osm's relations")
-        ("import-car-speed", "import car speed in ED");
+        ("import-car-speed", "import car speed in ED")
+        ("nb-threads", po::value<size_t>(&nb_threads)->default_value(std::max(1u, std::thread::hardware_concurrency())),
+            "number of threads used to match the nodes to their admin and to build the edges");
     // clang-format on
 
     po::variables_map vm;
@@ -1208,6 +1306,7 @@ int osm2ed(int argc, const char** argv) {
     persistor.clean_poi();
 
     ed::connectors::OSMCache cache(std::make_unique<Lotus>(connection_string), cities_cnx);
+    cache.nb_threads = std::max<size_t>(1, nb_threads);
     ed::connectors::ReadRelationsVisitor relations_visitor(cache, use_cities);
     osmpbfreader::read_osm_pbf(input, relations_visitor);
     ed::connectors::ReadWaysVisitor ways_visitor(cache, poi_params, speed_parser);
@@ -284,6 +284,8 @@ struct OSMCache {
 
     size_t admin_from_cities = 0;
     size_t cities_db_calls = 0;
+    // threads used to match the nodes to their admin and to build the edges while they are inserted
+    size_t nb_threads = 1;
 
     std::unique_ptr<Lotus> lotus;
 
@@ -298,6 +300,7 @@ struct OSMCache {
 
     void build_relations_geometries();
     const Admin* match_coord_admin(const double lon, const double lat);
+    const Admin* match_coord_admin_in_tree(const double lon, const double lat);
     const Admin* find_admin_in_cities(const double lon, const double lat);
     void match_nodes_admin();
     void insert_nodes();
@@ -159,3 +159,38 @@ BOOST_AUTO_TEST_CASE(osm_admin_without_zero_in_month_in_end_date) {
     relations_visitor.relation_callback(5, tags, ref);
     BOOST_CHECK(relations_visitor.cache.admins.find(5) == relations_visitor.cache.admins.end());
 }
+
+// Check that the nodes are matched to the city containing them when the matching is split between several threads
+BOOST_AUTO_TEST_CASE(osm_match_nodes_admin_with_several_threads) {
+    OSMCache cache(std::unique_ptr<Lotus>(), boost::none);
+    cache.nb_threads = 3;
+
+    mpolygon_type west_boundary, east_boundary;
+    boost::geometry::read_wkt("MULTIPOLYGON(((0 0,1 0,1 1,0 1)))", west_boundary);
+    boost::geometry::read_wkt("MULTIPOLYGON(((1 0,2 0,2 1,1 1)))", east_boundary);
+    cache.admins[1] = std::make_unique<Admin>(1, "admin:west", "", "", "West", 8, std::move(west_boundary),
+                                              point(0.5, 0.5));
+    cache.admins[2] = std::make_unique<Admin>(2, "admin:east", "", "", "East", 8, std::move(east_boundary),
+                                              point(1.5, 0.5));
+    cache.build_relations_geometries();
+
+    for (uint64_t id = 0; id < 100; ++id) {
+        cache.nodes.emplace(id).first->set_coord(0.01 + id * 0.025, 0.5);
+    }
+    // a node without coordinates has no admin
+    cache.nodes.emplace(100);
+
+    cache.match_nodes_admin();
+
+    for (const auto& node : cache.nodes) {
+        if (!node.is_defined()) {
+            BOOST_CHECK(node.admin == nullptr);
+        } else if (node.lon() < 1) {
+            BOOST_CHECK_EQUAL(node.admin, cache.admins[1].get());
+        } else if (node.lon() < 2) {
+            BOOST_CHECK_EQUAL(node.admin, cache.admins[2].get());
+        } else {
+            BOOST_CHECK(node.admin == nullptr);
+        }
+    }
+}
@@ -72,10 +72,8 @@ struct Admin : nt::Header, nt::Nameable {
     nt::GeographicalCoord coord;
     multi_polygon_type boundary;
     std::vector<const Admin*> admin_list;
-    std::vector<const nt::StopArea*> main_stop_areas;
-
-    // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
-    std::vector<const nt::StopPoint*> odt_stop_points;  // zone odt stop points for the admin
+    // the main stop areas and the odt stop points of the admin are stored in PT_Data
+    // (main_stop_areas_by_admin, odt_stop_points_by_admin)
     Postal_codes postal_codes;
 
     Admin() : level(-1) {}
@@ -92,8 +90,7 @@ struct Admin : nt::Header, nt::Nameable {
     std::string postal_codes_to_string() const;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
-        ar& idx& level& from_original_dataset& insee& name& uri& coord& admin_list& main_stop_areas& label&
-            odt_stop_points& postal_codes;
+        ar& idx& level& from_original_dataset& insee& name& uri& coord& admin_list& label& postal_codes;
     }
 };
 
@@ -66,9 +66,14 @@ void AstarPathFinder::start_distance_or_target_astar(const navitia::time_duratio
     }
     computation_launch = true;
     // We start astar from source and target nodes
+    auto heuristic = astar_distance_heuristic(geo_ref.graph, dest_projected, 1. / double(default_speed[mode]));
+    if (!geo_ref.landmarks[mode].empty()) {
+        heuristic.landmarks = &geo_ref.landmarks[mode];
+        heuristic.targets = destinations;
+        heuristic.speed_factor = speed_factor;
+    }
     try {
-        astar({starting_edge[source_e], starting_edge[target_e]},
-              astar_distance_heuristic(geo_ref.graph, dest_projected, 1. / double(default_speed[mode])),
+        astar({starting_edge[source_e], starting_edge[target_e]}, heuristic,
               astar_distance_or_target_visitor(radius, distances, destinations));
     } catch (DestinationFound&) {
     }
@@ -90,14 +95,13 @@ void AstarPathFinder::astar(const std::array<georef::vertex_t, 2>& origin_vertex
                         / boost::two_bit_color_map<>::elements_per_char,
               0);
 
-    // we filter the graph to only use certain mean of transport
-    using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, TransportationModeFilter>;
-    auto g = filtered_graph(geo_ref.graph, {}, TransportationModeFilter(mode, geo_ref));
-    auto weight_map = boost::get(&Edge::duration, geo_ref.graph);
     auto combiner = SpeedDistanceCombiner(speed_factor);
 
-    astar_shortest_paths_no_init_with_heap(g, origin_vertexes.front(), origin_vertexes.back(), heuristic, visitor,
-                                           weight_map, combiner);
+    // we filter the graph to only use certain mean of transport
+    visit_mode_graph(geo_ref, mode, [&](const auto& g, const auto& weight_map) {
+        astar_shortest_paths_no_init_with_heap(g, origin_vertexes.front(), origin_vertexes.back(), heuristic, visitor,
+                                               weight_map, combiner);
+    });
 }
 
 template <class Graph, class WeightMap, class Compare>
@@ -39,17 +39,25 @@ www.navitia.io
 namespace navitia {
 namespace georef {
 
-struct astar_distance_heuristic : public boost::astar_heuristic<Graph, navitia::seconds> {
+struct astar_distance_heuristic : public boost::astar_heuristic<Graph, navitia::time_duration> {
     const Graph& g;
     const type::GeographicalCoord& dest_coord;
     const double inv_speed;
+    // if set, the bound given by the landmarks toward the targets is used when it is better than the crow fly one
+    const Landmarks* landmarks = nullptr;
+    std::vector<vertex_t> targets;
+    float speed_factor = 1;
 
     astar_distance_heuristic(const Graph& graph, const type::GeographicalCoord& dest_projected, const double inv_speed)
         : g(graph), dest_coord(dest_projected), inv_speed(inv_speed) {}
 
-    navitia::seconds operator()(const vertex_t& v) const {
+    navitia::time_duration operator()(const vertex_t& v) const {
         auto const dist_to_target = dest_coord.distance_to(g[v].coord);
-        return navitia::seconds(dist_to_target * inv_speed);
+        navitia::time_duration res = navitia::seconds(dist_to_target * inv_speed);
+        if (landmarks != nullptr) {
+            res = std::max(res, landmarks->lower_bound(v, targets, speed_factor));
+        }
+        return res;
     }
 };
 
@@ -182,15 +182,17 @@ struct ProjectionGetterOnCoords {
     const type::Mode_e mode = type::Mode_e::Walking;
     ProjectionGetterOnCoords(const GeoRef& georef, const type::Mode_e mode) : georef(georef), mode(mode) {}
     const georef::ProjectionData operator()(const type::GeographicalCoord& coord) const {
-        try {
-            const auto& projection = georef.projected_coords.at(coord);
-            return projection[mode];
-        } catch (std::out_of_range&) {
-            return georef::ProjectionData{coord, georef, mode};
+        if (const auto* projection = georef.projected_coords.find(coord)) {
+            return (*projection)[mode];
         }
+        return georef::ProjectionData{coord, georef, mode};
     }
 };
 
+ProjectionData project_destination(const GeoRef& geo_ref, const type::GeographicalCoord& coord, nt::Mode_e mode) {
+    return ProjectionGetterOnCoords(geo_ref, mode == type::Mode_e::Car ? nt::Mode_e::Walking : mode)(coord);
+}
+
 boost::container::flat_map<DijkstraPathFinder::coord_uri, georef::RoutingElement>
 DijkstraPathFinder::get_duration_with_dijkstra(const navitia::time_duration& radius,
                                                const std::vector<type::GeographicalCoord>& dest_coords) {
@@ -203,6 +205,54 @@ DijkstraPathFinder::get_duration_with_dijkstra(const navitia::time_duration& rad
                                                 ProjectionGetterOnCoords>(radius, dest_coords, projection_getter);
 }
 
+std::vector<georef::RoutingElement> DijkstraPathFinder::get_duration_with_dijkstra(
+    const navitia::time_duration& radius,
+    const std::vector<ProjectionData>& destinations) {
+    std::vector<georef::RoutingElement> result(
+        destinations.size(), georef::RoutingElement(navitia::time_duration(), georef::RoutingStatus_e::unknown));
+    // the duration to a destination is computed from the 2 vertices of its edge
+    std::vector<vertex_t> target_vertices;
+    for (const auto& projection : destinations) {
+        if (projection.found) {
+            target_vertices.push_back(projection[source_e]);
+            target_vertices.push_back(projection[target_e]);
+        }
+    }
+    // if there are no destinations projected on the graph, there is no need to start the dijkstra
+    if (target_vertices.empty()) {
+        return result;
+    }
+
+    if (starting_edge.found) {
+        computation_launch = true;
+        try {
+            dijkstra({starting_edge[source_e], starting_edge[target_e]},
+                     dijkstra_distance_or_target_visitor(radius, distances, target_vertices));
+        } catch (const DestinationFound&) {
+        }
+    }
+
+    for (size_t i = 0; i < destinations.size(); ++i) {
+        const auto& projection = destinations[i];
+        if (!projection.found) {
+            continue;
+        }
+        // same as in start_dijkstra_and_fill_duration_map
+        navitia::time_duration duration;
+        if (is_projected_on_same_edge(starting_edge, projection)) {
+            duration = path_duration_on_same_edge(starting_edge, projection);
+        } else {
+            duration = find_nearest_vertex(projection, true).first;
+        }
+        if (duration <= radius) {
+            result[i] = georef::RoutingElement(duration, georef::RoutingStatus_e::reached);
+        } else {
+            result[i] = georef::RoutingElement(navitia::time_duration(), georef::RoutingStatus_e::unreached);
+        }
+    }
+    return result;
+}
+
 template <class Visitor>
 void DijkstraPathFinder::dijkstra(const std::array<georef::vertex_t, 2>& origin_vertexes, const Visitor& visitor) {
     // Note: the predecessors have been updated in init
@@ -213,14 +263,13 @@ void DijkstraPathFinder::dijkstra(const std::array<georef::vertex_t, 2>& origin_
                         / boost::two_bit_color_map<>::elements_per_char,
               0);
 
-    // we filter the graph to only use certain mean of transport
-    using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, TransportationModeFilter>;
-    auto const g = filtered_graph(geo_ref.graph, {}, TransportationModeFilter(mode, geo_ref));
-    auto const weight_map = boost::get(&Edge::duration, geo_ref.graph);
     auto const combiner = SpeedDistanceCombiner(speed_factor);  // we multiply the edge duration by a speed factor
 
-    dijkstra_shortest_paths_no_init_with_heap(g, origin_vertexes.front(), origin_vertexes.back(), visitor, weight_map,
-                                              combiner);
+    // we filter the graph to only use certain mean of transport
+    visit_mode_graph(geo_ref, mode, [&](const auto& g, const auto& weight_map) {
+        dijkstra_shortest_paths_no_init_with_heap(g, origin_vertexes.front(), origin_vertexes.back(), visitor,
+                                                  weight_map, combiner);
+    });
 }
 
 std::pair<navitia::time_duration, ProjectionData::Direction> DijkstraPathFinder::update_path(
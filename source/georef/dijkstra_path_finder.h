@@ -38,6 +38,10 @@ www.navitia.io
 namespace navitia {
 namespace georef {
 
+// projection of a destination for a dijkstra in the given mode (cars are left on a parking and we walk to the
+// destination)
+ProjectionData project_destination(const GeoRef& geo_ref, const type::GeographicalCoord& coord, nt::Mode_e mode);
+
 class DijkstraPathFinder : public PathFinder {
 public:
     DijkstraPathFinder(const GeoRef& geo_ref) : PathFinder(geo_ref) {}
@@ -59,6 +63,13 @@ public:
         const navitia::time_duration& radius,
         const std::vector<type::GeographicalCoord>& dest_coords);
 
+    /**
+     * Same as above, with destinations already projected (see project_destination), the durations being
+     * in the order of the destinations. The dijkstra stops as soon as all the destinations are reached.
+     **/
+    std::vector<georef::RoutingElement> get_duration_with_dijkstra(const navitia::time_duration& radius,
+                                                                   const std::vector<ProjectionData>& destinations);
+
     /**
      * Launch a dijkstra without initializing the data structure
      * Warning, it modifies the distances and the predecessors
@@ -54,5 +54,10 @@ struct Edge {
     Edge() = default;
 };
 
+/** Edge properties kept in the SearchGraph: only what the searches read */
+struct SearchEdge {
+    navitia::time_duration duration = {};
+};
+
 }  // namespace georef
 }  // namespace navitia
@@ -46,6 +46,7 @@ www.navitia.io
 #include <boost/range/algorithm/sort.hpp>
 
 #include <array>
+#include <future>
 #include <unordered_map>
 
 using navitia::type::idx_t;
@@ -360,6 +361,7 @@ static bool is_sn_edge(const GeoRef& georef, const edge_t& e) {
  * walking graph offset)
  */
 void GeoRef::init() {
+    search_graph_up_to_date = false;
     offsets[nt::Mode_e::Walking] = 0;
     offsets[nt::Mode_e::Bss] = 0;
 
@@ -411,6 +413,29 @@ void GeoRef::build_proximity_list() {
     poi_proximity_list.build();
 }
 
+void GeoRef::build_landmarks(const size_t nb_landmarks) {
+    auto log = log4cplus::Logger::getInstance("GeoRef::build_landmarks");
+    for (const auto mode : {nt::Mode_e::Bike, nt::Mode_e::Car, nt::Mode_e::CarNoPark}) {
+        landmarks[mode] = compute_landmarks(*this, mode, nb_landmarks);
+        LOG4CPLUS_INFO(log, landmarks[mode].nb_landmarks << " landmarks for the mode " << mode);
+    }
+}
+
+void GeoRef::build_search_graph() {
+    auto log = log4cplus::Logger::getInstance("GeoRef::build_search_graph");
+    // the edges of an adjacency_list are iterated vertex by vertex, so they are already sorted by source
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<SearchEdge> edge_properties;
+    for (const auto& e : boost::make_iterator_range(boost::edges(graph))) {
+        edges.emplace_back(boost::source(e, graph), boost::target(e, graph));
+        edge_properties.push_back({graph[e].duration});
+    }
+    search_graph = SearchGraph(boost::edges_are_sorted, edges.begin(), edges.end(), edge_properties.begin(),
+                               boost::num_vertices(graph));
+    search_graph_up_to_date = true;
+    LOG4CPLUS_INFO(log, "search graph built with " << boost::num_edges(search_graph) << " edges");
+}
+
 static const Admin* find_city_admin(const std::vector<Admin*>& admins) {
     for (Admin* admin : admins) {
         // Level 8: City
@@ -551,7 +576,16 @@ std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> GeoRef::find_ways(
     return to_return;
 }
 
-void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points) {
+const GeoRef::ProjectionByMode* GeoRef::ProjectedCoords::find(const nt::GeographicalCoord& coord) const {
+    const auto it = std::lower_bound(coords.begin(), coords.end(), coord);
+    if (it == coords.end() || coord < *it) {
+        return nullptr;
+    }
+    return &projections[it - coords.begin()];
+}
+
+void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points,
+                                                   size_t nb_threads) {
     enum class error {
         matched = 0,
         matched_walking,
@@ -569,11 +603,63 @@ void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopP
 
     this->projected_stop_points.reserve(stop_points.size());
 
-    this->projected_coords.clear();
-    // This projection cache is used by distributed scenari. It contains projections for
-    // both stop points and access points. Since we cannot know the exact number of access points
-    // ahead of time, we just suppose every stop point has at least one access point. Thus the factor is 2.
-    this->projected_coords.reserve(stop_points.size() * 2);
+    /*
+     * We build 2 different caches :
+     *  1. projected_stop_points : based on the stop_point id for NewDefault
+     *  2. projected_coords : based on GeographicalCoord for distributed.
+     *
+     *  TODO: remove projected_stop_points and replace it with the other one.
+     *  This could save us spave, but the Dijkstra related interface for Georef
+     *  needs a lot of rework.
+     *
+     * The projected_coords contains the projections of both stop points and access points.
+     * Each distinct coord is projected once, the projections are independent so they are
+     * computed by batches on several threads.
+     */
+    auto& coords = this->projected_coords.coords;
+    coords.clear();
+    for (const type::StopPoint* stop_point : stop_points) {
+        coords.push_back(stop_point->coord);
+        for (const auto& ap : stop_point->access_points) {
+            coords.push_back(ap.coord);
+        }
+    }
+    boost::sort(coords);
+    coords.erase(std::unique(coords.begin(), coords.end(),
+                             [](const nt::GeographicalCoord& a, const nt::GeographicalCoord& b) {
+                                 return !(a < b) && !(b < a);
+                             }),
+                 coords.end());
+    coords.shrink_to_fit();
+
+    std::vector<std::pair<GeoRef::ProjectionByMode, bool>> projections(coords.size());
+    nb_threads = std::max<size_t>(nb_threads, 1);
+    const size_t nb_batches = nb_threads * 4;
+    const size_t batch_size = coords.size() / nb_batches + 1;
+    auto project_batches = [&](const size_t first_batch) {
+        for (size_t batch = first_batch; batch < nb_batches; batch += nb_threads) {
+            const auto begin = std::min(batch * batch_size, coords.size());
+            const auto end = std::min(begin + batch_size, coords.size());
+            for (auto i = begin; i < end; ++i) {
+                projections[i] = project_coord(coords[i]);
+            }
+        }
+    };
+    std::vector<std::future<void>> workers;
+    for (size_t i = 1; i < nb_threads; ++i) {
+        workers.push_back(std::async(std::launch::async, project_batches, i));
+    }
+    project_batches(0);
+    for (auto& worker : workers) {
+        worker.get();
+    }
+
+    auto& projections_by_coord = this->projected_coords.projections;
+    projections_by_coord.clear();
+    projections_by_coord.reserve(projections.size());
+    for (const auto& projection : projections) {
+        projections_by_coord.push_back(projection.first);
+    }
 
     auto update_message = [](navitia::flat_enum_map<error, int>& messages,
                              const std::pair<GeoRef::ProjectionByMode, bool>& p,
@@ -600,35 +686,29 @@ void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopP
             messages[error::matched_car] += 1;
         }
     };
+    auto coord_idx = [&coords](const nt::GeographicalCoord& coord) -> size_t {
+        return std::lower_bound(coords.begin(), coords.end(), coord) - coords.begin();
+    };
 
+    // an access point is only counted the first time its coord is met
+    std::vector<bool> counted(coords.size(), false);
     int access_points_num = 0;
     for (const type::StopPoint* stop_point : stop_points) {
-        std::pair<GeoRef::ProjectionByMode, bool> pair = project_coord(stop_point->coord);
-
-        /*
-         * We build 2 different caches :
-         *  1. projected_stop_points : based on the stop_point id for NewDefault
-         *  2. projected_coords : based on GeographicalCoord for distributed.
-         *
-         *  TODO: remove projected_stop_points and replace it with the other one.
-         *  This could save us spave, but the Dijkstra related interface for Georef
-         *  needs a lot of rework.
-         */
-        this->projected_stop_points.push_back(pair.first);
-        this->projected_coords[stop_point->coord] = pair.first;
+        const auto sp_idx = coord_idx(stop_point->coord);
+        this->projected_stop_points.push_back(projections[sp_idx].first);
+        counted[sp_idx] = true;
 
-        update_message(stop_point_messages, pair, stop_point->coord);
+        update_message(stop_point_messages, projections[sp_idx], stop_point->coord);
 
         for (const auto& ap : stop_point->access_points) {
-            auto it = projected_coords.find(ap.coord);
-            if (it != projected_coords.end()) {
+            const auto ap_idx = coord_idx(ap.coord);
+            if (counted[ap_idx]) {
                 continue;
             }
-            std::pair<GeoRef::ProjectionByMode, bool> ap_pair = project_coord(ap.coord);
-            this->projected_coords[ap.coord] = ap_pair.first;
+            counted[ap_idx] = true;
             ++access_points_num;
 
-            update_message(access_point_messages, ap_pair, ap.coord);
+            update_message(access_point_messages, projections[ap_idx], ap.coord);
         }
     }
 
@@ -891,6 +971,7 @@ bool GeoRef::add_bss_edges(const type::GeographicalCoord& coord) {
     // time needed to hang the bike back + time to walk between the edges
     edge.duration = dur_between_edges + default_time_bss_putback;
     add_edge(biking_v, walking_v, edge, graph);
+    search_graph_up_to_date = false;
 
     return true;
 }
@@ -926,6 +1007,7 @@ bool GeoRef::add_parking_edges(const type::GeographicalCoord& coord) {
     // time needed to park the car + time to walk between the edges
     edge.duration = dur_between_edges + default_time_parking_park;
     add_edge(car_v, walking_v, edge, graph);
+    search_graph_up_to_date = false;
 
     return true;
 }
@@ -38,6 +38,7 @@ www.navitia.io
 #include "type/time_duration.h"
 #include "georef/fwd_georef.h"
 #include "georef/georef_types.h"
+#include "georef/landmarks.h"
 #include "georef/projection_data.h"
 
 #include <boost/graph/adj_list_serialize.hpp>
@@ -216,12 +217,32 @@ struct GeoRef {
     using ProjectionByMode = flat_enum_map<nt::Mode_e, ProjectionData>;
     std::vector<ProjectionByMode> projected_stop_points = {};
 
-    using ProjectedCoords = std::unordered_map<nt::GeographicalCoord, ProjectionByMode>;
+    /// projections of the stop points and access points by coord, the coords are sorted for a binary search
+    struct ProjectedCoords {
+        std::vector<nt::GeographicalCoord> coords;
+        std::vector<ProjectionByMode> projections;
+
+        /// return nullptr if the coord has not been projected
+        const ProjectionByMode* find(const nt::GeographicalCoord& coord) const;
+        size_t size() const { return coords.size(); }
+        void clear() {
+            coords.clear();
+            projections.clear();
+        }
+    };
     ProjectedCoords projected_coords;
 
+    /// landmarks for the A* of the direct paths, not serialized: computed at load time if asked
+    flat_enum_map<nt::Mode_e, Landmarks> landmarks;
+
     /// Graphe pour effectuer le calcul d'itinéraire
     Graph graph;
 
+    /// compact copy of the graph for the path finders, not serialized: built at load time
+    SearchGraph search_graph;
+    /// reset by the methods modifying the graph, the search graph must then be built again
+    bool search_graph_up_to_date = false;
+
     /*
      * We have 3 graphs :
      *  1/ for walking
@@ -253,6 +274,7 @@ struct GeoRef {
         // La désérialisation d'une boost adjacency list ne vide pas le graphe
         // On avait donc une fuite de mémoire
         graph.clear();
+        search_graph_up_to_date = false;
         ar& ways& way_map& graph& offsets& fl_admin& fl_way& projected_stop_points& admins& admin_map& pois& fl_poi&
             poitypes& poitype_map& poi_map& synonyms& ghostwords& poi_proximity_list& nb_vertex_by_mode;
     }
@@ -261,6 +283,19 @@ struct GeoRef {
     /** Construit l'indexe spatial */
     void build_proximity_list();
 
+    /** Compute the landmarks of the bike and car graphs */
+    void build_landmarks(size_t nb_landmarks);
+
+    /** Build the search graph, must be called again if the graph is modified */
+    void build_search_graph();
+    /** The path finders use the search graph if it is up to date, the graph otherwise
+     *
+     * The vertex count is checked too for the builders adding vertices directly to the graph
+     */
+    bool has_search_graph() const {
+        return search_graph_up_to_date && boost::num_vertices(search_graph) == boost::num_vertices(graph);
+    }
+
     ///  Construit l'indexe autocomplete à partir des rues
     void build_autocomplete_list();
 
@@ -284,8 +319,10 @@ struct GeoRef {
 
     /**
      * Project each stop_point and their access points(if any) on the georef network
+     * The coords are projected by nb_threads threads, the result does not depend on it
      */
-    void project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points);
+    void project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points,
+                                               size_t nb_threads = 1);
 
     /** project the a coordinate on all transportation mode
      * return a pair with :
@@ -3,6 +3,13 @@
 
 #include "georef/edge.h"
 #include <boost/graph/adjacency_list.hpp>
+// the searches must be declared before the compressed sparse row graph: its boost::detail::get overload
+// would otherwise hide boost::get for the raw pointer property maps (distances, predecessors) they use
+#include <boost/graph/astar_search.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+
+#include <cstdint>
 
 namespace navitia {
 namespace georef {
@@ -28,5 +35,19 @@ using edge_t = boost::graph_traits<Graph>::edge_descriptor;
 /// Pour parcourir les segements du graphe
 using edge_iterator = boost::graph_traits<Graph>::edge_iterator;
 
+/** Compact copy of the Graph, in compressed sparse row layout, used by the path finders
+ *
+ * The out edges of all the vertices are stored in one offset array and one target array, and the
+ * edge durations in a third one, so relaxing the edges of a vertex reads contiguous memory instead
+ * of a heap block per vertex and per edge. It has the same vertices, and each vertex has the same
+ * out edges in the same order, so the searches give the same results on both graphs.
+ */
+using SearchGraph = boost::compressed_sparse_row_graph<boost::directedS,
+                                                       boost::no_property,
+                                                       SearchEdge,
+                                                       boost::no_property,
+                                                       uint32_t,
+                                                       uint32_t>;
+
 }  // namespace georef
 }  // namespace navitia
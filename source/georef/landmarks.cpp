@@ -0,0 +1,172 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "landmarks.h"
+
+#include "georef.h"
+#include "path_finder.h"
+
+#include <boost/range/iterator_range.hpp>
+
+#include <queue>
+
+namespace navitia {
+namespace georef {
+
+size_t Landmarks::index(const vertex_t v) const {
+    const size_t graph_number = v / nb_vertex_by_mode;
+    for (size_t i = 0; i < graph_numbers.size(); ++i) {
+        if (graph_numbers[i] == graph_number) {
+            return i * nb_vertex_by_mode + v % nb_vertex_by_mode;
+        }
+    }
+    return nb_vertices();
+}
+
+navitia::time_duration Landmarks::lower_bound(const vertex_t v,
+                                              const std::vector<vertex_t>& targets,
+                                              const float speed_factor) const {
+    const auto v_idx = index(v);
+    if (v_idx == nb_vertices()) {
+        return navitia::seconds(0);
+    }
+    navitia::time_duration res = bt::pos_infin;
+    const auto* from_v = &durations[v_idx * nb_landmarks];
+    for (const auto target : targets) {
+        const auto target_idx = index(target);
+        if (target_idx == nb_vertices()) {
+            return navitia::seconds(0);
+        }
+        navitia::time_duration bound = navitia::seconds(0);
+        const auto* from_target = &durations[target_idx * nb_landmarks];
+        for (size_t l = 0; l < nb_landmarks; ++l) {
+            // no bound can be deduced from a landmark that cannot reach both vertices
+            if (from_v[l].is_special() || from_target[l].is_special()) {
+                continue;
+            }
+            bound = std::max(bound, from_target[l] - from_v[l]);
+        }
+        res = std::min(res, bound);
+    }
+    if (res.is_special()) {
+        return navitia::seconds(0);
+    }
+    // same rounding as SpeedDistanceCombiner, with a factor never greater than 1
+    return speed_factor > 1 ? res * (1.f / speed_factor) : res;
+}
+
+namespace {
+
+// plain dijkstra on the graph of the mode, without any radius
+std::vector<navitia::time_duration> durations_from(const GeoRef& geo_ref,
+                                                   const type::Mode_e mode,
+                                                   const Landmarks& landmarks,
+                                                   const vertex_t source) {
+    std::vector<navitia::time_duration> res(landmarks.nb_vertices(), bt::pos_infin);
+    using Label = std::pair<navitia::time_duration, vertex_t>;
+    std::priority_queue<Label, std::vector<Label>, std::greater<Label>> queue;
+
+    res[landmarks.index(source)] = navitia::seconds(0);
+    queue.emplace(navitia::seconds(0), source);
+    visit_mode_graph(geo_ref, mode, [&](const auto& g, const auto& weight_map) {
+        while (!queue.empty()) {
+            const auto label = queue.top();
+            queue.pop();
+            if (res[landmarks.index(label.second)] < label.first) {
+                continue;
+            }
+            for (const auto& e : boost::make_iterator_range(boost::out_edges(label.second, g))) {
+                const vertex_t v = boost::target(e, g);
+                const auto duration = label.first + boost::get(weight_map, e);
+                auto& v_duration = res[landmarks.index(v)];
+                if (duration < v_duration) {
+                    v_duration = duration;
+                    queue.emplace(duration, v);
+                }
+            }
+        }
+    });
+    return res;
+}
+
+}  // namespace
+
+Landmarks compute_landmarks(const GeoRef& geo_ref, const type::Mode_e mode, const size_t nb_landmarks) {
+    Landmarks res;
+    if (nb_landmarks == 0 || geo_ref.nb_vertex_by_mode == 0) {
+        return res;
+    }
+    // the filtered graph of the mode only keeps the vertices of some copies of the graph, the durations
+    // are only stored for them
+    res.nb_vertex_by_mode = geo_ref.nb_vertex_by_mode;
+    for (const auto& allowed_mode : allowed_transportation_mode[mode]) {
+        if (allowed_mode.second) {
+            res.graph_numbers.push_back(size_t(allowed_mode.first));
+        }
+    }
+    const auto nb_vertices = res.nb_vertices();
+
+    // the first landmark is the vertex the farthest from the first vertex of the graph of the mode
+    auto min_durations = durations_from(geo_ref, mode, res, geo_ref.offsets[mode]);
+    std::vector<std::vector<navitia::time_duration>> durations_by_landmark;
+    while (durations_by_landmark.size() < nb_landmarks) {
+        size_t farthest = nb_vertices;
+        for (size_t i = 0; i < nb_vertices; ++i) {
+            if (min_durations[i].is_special()) {
+                continue;
+            }
+            if (farthest == nb_vertices || min_durations[farthest] < min_durations[i]) {
+                farthest = i;
+            }
+        }
+        if (farthest == nb_vertices || min_durations[farthest] == navitia::seconds(0)) {
+            // all the reachable vertices are already landmarks
+            break;
+        }
+        durations_by_landmark.push_back(durations_from(geo_ref, mode, res, res.vertex(farthest)));
+        const auto& durations = durations_by_landmark.back();
+        for (size_t i = 0; i < nb_vertices; ++i) {
+            min_durations[i] =
+                durations_by_landmark.size() == 1 ? durations[i] : std::min(min_durations[i], durations[i]);
+        }
+    }
+
+    res.nb_landmarks = durations_by_landmark.size();
+    res.durations.resize(nb_vertices * res.nb_landmarks);
+    for (size_t i = 0; i < nb_vertices; ++i) {
+        for (size_t l = 0; l < res.nb_landmarks; ++l) {
+            res.durations[i * res.nb_landmarks + l] = durations_by_landmark[l][i];
+        }
+    }
+    return res;
+}
+
+}  // namespace georef
+}  // namespace navitia
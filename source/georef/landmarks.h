@@ -0,0 +1,97 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+#include "georef/georef_types.h"
+#include "type/time_duration.h"
+#include "type/type_interfaces.h"
+
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+struct GeoRef;
+
+/**
+ * Landmarks of a transportation mode, used to speed up the A* of the direct paths (ALT algorithm)
+ *
+ * For a landmark L, the triangle inequality gives d(L, t) <= d(L, v) + d(v, t), so
+ * d(L, t) - d(L, v) is a lower bound of the duration from v to t at the default speed of the mode.
+ * The best of these bounds is a much tighter heuristic than the crow fly distance. It is only
+ * admissible (and the A* only exact) once scaled by the speed factor of the request, see lower_bound.
+ */
+struct Landmarks {
+    size_t nb_landmarks = 0;
+    size_t nb_vertex_by_mode = 0;
+
+    // the copies of the graph (one per mode) used by the graph of the mode, in the order of the durations
+    std::vector<size_t> graph_numbers;
+
+    // durations from each landmark to each vertex of the graph of the mode (pos_infin if not reachable),
+    // stored vertex by vertex: the duration from the landmark l to the vertex v is
+    // durations[index(v) * nb_landmarks + l]
+    std::vector<navitia::time_duration> durations;
+
+    bool empty() const { return nb_landmarks == 0; }
+
+    /// number of vertices of the graph of the mode
+    size_t nb_vertices() const { return graph_numbers.size() * nb_vertex_by_mode; }
+
+    /// position of v among the vertices of the graph of the mode, nb_vertices() if it is not one of them
+    size_t index(const vertex_t v) const;
+
+    /// vertex at the position i among the vertices of the graph of the mode
+    vertex_t vertex(const size_t i) const {
+        return graph_numbers[i / nb_vertex_by_mode] * nb_vertex_by_mode + i % nb_vertex_by_mode;
+    }
+
+    /**
+     * lower bound of the duration from v to the nearest target
+     *
+     * The durations of the edges are divided by the speed factor during the search, the bound must be
+     * too when the request is faster than the default speed. It is not multiplied back when the request is
+     * slower, the bound is still admissible then.
+     */
+    navitia::time_duration lower_bound(const vertex_t v,
+                                       const std::vector<vertex_t>& targets,
+                                       const float speed_factor = 1) const;
+};
+
+/**
+ * Pick nb_landmarks landmarks in the graph of the mode and compute the durations from them
+ *
+ * Each landmark is the vertex the farthest from the landmarks already picked, and costs one dijkstra
+ * on the whole graph of the mode.
+ */
+Landmarks compute_landmarks(const GeoRef& geo_ref, const type::Mode_e mode, const size_t nb_landmarks);
+
+}  // namespace georef
+}  // namespace navitia
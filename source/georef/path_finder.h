@@ -33,6 +33,7 @@ www.navitia.io
 #include "georef.h"
 #include "routing/raptor_utils.h"
 
+#include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/two_bit_color_map.hpp>
 #include <utility>
 
@@ -99,6 +100,23 @@ struct TransportationModeFilter {
     }
 };
 
+/**
+ * Call f(graph, duration_map) with the graph filtered for the mode
+ *
+ * The compact search graph is used if it has been built, the graph otherwise
+ */
+template <typename F>
+void visit_mode_graph(const GeoRef& geo_ref, const nt::Mode_e mode, F&& f) {
+    const auto filter = TransportationModeFilter(mode, geo_ref);
+    if (geo_ref.has_search_graph()) {
+        using filtered_graph = boost::filtered_graph<SearchGraph, boost::keep_all, TransportationModeFilter>;
+        f(filtered_graph(geo_ref.search_graph, {}, filter), boost::get(&SearchEdge::duration, geo_ref.search_graph));
+    } else {
+        using filtered_graph = boost::filtered_graph<Graph, boost::keep_all, TransportationModeFilter>;
+        f(filtered_graph(geo_ref.graph, {}, filter), boost::get(&Edge::duration, geo_ref.graph));
+    }
+}
+
 struct SpeedDistanceCombiner
     : public std::binary_function<navitia::time_duration, navitia::time_duration, navitia::time_duration> {
     // speed factor compared to the default speed of the transportation mode
@@ -0,0 +1,109 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "street_network_matrix.h"
+
+#include "georef.h"
+
+#include <exception>
+#include <future>
+
+namespace navitia {
+namespace georef {
+
+StreetNetworkMatrix::StreetNetworkMatrix(const GeoRef& geo_ref, size_t nb_threads)
+    : geo_ref(geo_ref), workers(std::max(nb_threads, size_t(1)) - 1) {
+    for (size_t i = 0; i < std::max(nb_threads, size_t(1)); ++i) {
+        path_finders.push_back(std::make_unique<DijkstraPathFinder>(geo_ref));
+    }
+}
+
+std::vector<std::vector<RoutingElement>> StreetNetworkMatrix::compute(
+    const std::vector<type::EntryPoint>& origins,
+    const std::vector<type::GeographicalCoord>& destinations,
+    const navitia::time_duration& max_duration) {
+    std::vector<std::vector<RoutingElement>> rows(origins.size());
+    if (destinations.empty()) {
+        return rows;
+    }
+
+    // the destinations are projected once for each mode used by the origins
+    map_by_mode<std::vector<ProjectionData>> projections;
+    for (const auto& origin : origins) {
+        auto& mode_projections = projections[origin.streetnetwork_params.mode];
+        if (!mode_projections.empty()) {
+            continue;
+        }
+        mode_projections.reserve(destinations.size());
+        for (const auto& coord : destinations) {
+            mode_projections.push_back(project_destination(geo_ref, coord, origin.streetnetwork_params.mode));
+        }
+    }
+
+    // the thread i computes the rows i, i + nb_threads, i + 2 * nb_threads...
+    const size_t nb_threads = std::min(path_finders.size(), origins.size());
+    const auto& destination_projections = projections;
+    auto compute_rows = [&](size_t thread_idx) {
+        auto& path_finder = *path_finders[thread_idx];
+        for (size_t i = thread_idx; i < origins.size(); i += nb_threads) {
+            const auto& origin = origins[i];
+            path_finder.init(origin.coordinates, origin.streetnetwork_params.mode,
+                             origin.streetnetwork_params.speed_factor);
+            rows[i] = path_finder.get_duration_with_dijkstra(
+                max_duration, destination_projections[origin.streetnetwork_params.mode]);
+        }
+    };
+    std::vector<std::future<void>> futures;
+    for (size_t thread_idx = 1; thread_idx < nb_threads; ++thread_idx) {
+        futures.push_back(workers.push([&compute_rows, thread_idx]() { compute_rows(thread_idx); }));
+    }
+    std::exception_ptr error;
+    if (nb_threads > 0) {
+        try {
+            compute_rows(0);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    // the rows use the locals of this frame, they must all be over before anything is rethrown
+    for (const auto& future : futures) {
+        future.wait();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    return rows;
+}
+
+}  // namespace georef
+}  // namespace navitia
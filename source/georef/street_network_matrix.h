@@ -0,0 +1,70 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+#include "dijkstra_path_finder.h"
+#include "type/entry_point.h"
+#include "type/time_duration.h"
+#include "type/worker_pool.h"
+
+#include <memory>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/**
+ * Street network durations from several origins to several destinations, computed by parallel rows
+ *
+ * Each row is one dijkstra from its origin, that stops as soon as all the destinations are reached; the
+ * destinations are projected once for all the origins, and the rows are computed on several threads.
+ * No search is shared between the origins: the graph only has the out edges of its vertices, so a
+ * search from the destinations would need a reversed copy of the street network.
+ */
+struct StreetNetworkMatrix {
+    // each thread has its own path finder, and thus its own distances on the whole graph
+    StreetNetworkMatrix(const GeoRef& geo_ref, size_t nb_threads = 1);
+
+    /**
+     * Return the durations from each origin (rows) to each destination (columns), with the
+     * same statuses than DijkstraPathFinder::get_duration_with_dijkstra
+     **/
+    std::vector<std::vector<RoutingElement>> compute(const std::vector<type::EntryPoint>& origins,
+                                                     const std::vector<type::GeographicalCoord>& destinations,
+                                                     const navitia::time_duration& max_duration);
+
+    const GeoRef& geo_ref;
+    std::vector<std::unique_ptr<DijkstraPathFinder>> path_finders;
+    // run the rows of the path finders but the first one, that is used by the calling thread
+    WorkerPool workers;
+};
+
+}  // namespace georef
+}  // namespace navitia
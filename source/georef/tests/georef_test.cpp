@@ -874,6 +874,72 @@ BOOST_AUTO_TEST_CASE(compute_nearest) {
     BOOST_CHECK_EQUAL_COLLECTIONS(res.cbegin(), res.cend(), tested_map.cbegin(), tested_map.cend());
 }
 
+// The projections must not depend on the number of threads used to compute them
+BOOST_AUTO_TEST_CASE(project_stop_points_and_access_points_with_several_threads) {
+    using namespace navitia::type;
+
+    GraphBuilder b;
+
+    /*
+     *    o------o------o------o------o
+     *    a      b      c      d      e
+     */
+    b("a", 0, 0)("b", 100, 0)("c", 200, 0)("d", 300, 0)("e", 400, 0);
+    b("a", "b", 100_s)("b", "a", 100_s)("b", "c", 100_s)("c", "b", 100_s)("c", "d", 100_s)("d", "c", 100_s)(
+        "d", "e", 100_s)("e", "d", 100_s);
+    b.init();
+
+    // some stop points share their coord, each stop point has an access point
+    std::vector<std::unique_ptr<StopPoint>> stop_points_storage;
+    std::vector<StopPoint*> stop_points;
+    for (size_t i = 0; i < 30; ++i) {
+        auto sp = std::make_unique<StopPoint>();
+        sp->idx = i;
+        sp->coord = GeographicalCoord((i % 20) * 20 + 5, 10, false);
+        AccessPoint ap;
+        ap.uri = "ap:" + std::to_string(i);
+        ap.coord = GeographicalCoord((i % 20) * 20 + 15, -10, false);
+        sp->access_points.insert(ap);
+        stop_points.push_back(sp.get());
+        stop_points_storage.push_back(std::move(sp));
+    }
+
+    b.geo_ref.project_stop_points_and_access_points(stop_points, 1);
+    const auto projected_stop_points = b.geo_ref.projected_stop_points;
+    const auto projected_coords = b.geo_ref.projected_coords;
+    // 20 distinct coords for the stop points and 20 for the access points
+    BOOST_CHECK_EQUAL(projected_coords.size(), 40);
+
+    b.geo_ref.project_stop_points_and_access_points(stop_points, 3);
+    BOOST_REQUIRE_EQUAL(b.geo_ref.projected_stop_points.size(), projected_stop_points.size());
+    BOOST_REQUIRE_EQUAL(b.geo_ref.projected_coords.size(), projected_coords.size());
+
+    auto check_same = [](const GeoRef::ProjectionByMode& a, const GeoRef::ProjectionByMode& b) {
+        for (const auto mode : {Mode_e::Walking, Mode_e::Bike, Mode_e::Car}) {
+            BOOST_CHECK_EQUAL(a[mode].found, b[mode].found);
+            BOOST_CHECK_EQUAL(a[mode][ProjectionData::Direction::Source],
+                              b[mode][ProjectionData::Direction::Source]);
+            BOOST_CHECK_EQUAL(a[mode][ProjectionData::Direction::Target],
+                              b[mode][ProjectionData::Direction::Target]);
+            BOOST_CHECK_CLOSE(a[mode].distances[ProjectionData::Direction::Source],
+                              b[mode].distances[ProjectionData::Direction::Source], 1e-6);
+        }
+    };
+    for (size_t i = 0; i < stop_points.size(); ++i) {
+        check_same(b.geo_ref.projected_stop_points[i], projected_stop_points[i]);
+
+        const auto* sp_projection = b.geo_ref.projected_coords.find(stop_points[i]->coord);
+        BOOST_REQUIRE(sp_projection != nullptr);
+        check_same(*sp_projection, projected_stop_points[i]);
+
+        const auto& ap_coord = stop_points[i]->access_points.begin()->coord;
+        const auto* ap_projection = b.geo_ref.projected_coords.find(ap_coord);
+        BOOST_REQUIRE(ap_projection != nullptr);
+        check_same(*ap_projection, *projected_coords.find(ap_coord));
+    }
+    BOOST_CHECK(b.geo_ref.projected_coords.find(GeographicalCoord(1000, 1000, false)) == nullptr);
+}
+
 // Récupérer les cordonnées d'un numéro impair :
 BOOST_AUTO_TEST_CASE(numero_impair) {
     navitia::georef::Way way;
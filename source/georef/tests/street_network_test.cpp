@@ -37,6 +37,7 @@ www.navitia.io
 #include "type/stop_point.h"
 
 #include "georef/street_network.h"
+#include "georef/street_network_matrix.h"
 #include <boost/test/unit_test.hpp>
 #include <utility>
 
@@ -234,3 +235,190 @@ BOOST_AUTO_TEST_CASE(astar_init) {
         BOOST_CHECK_THROW(worker.costs.at(worker.starting_edge[dir::Target]), proximitylist::NotFound);
     }
 }
+
+/**
+ * The street network matrix must give the same durations and statuses than a dijkstra by origin
+ **/
+BOOST_AUTO_TEST_CASE(street_network_matrix_same_as_dijkstra_by_origin) {
+    GraphBuilder b;
+    type::Data data;
+    build_data(b, data);
+
+    std::vector<type::EntryPoint> origins;
+    for (const auto& xy : {std::make_pair(2., 2.), std::make_pair(0., 5.), std::make_pair(7., 3.)}) {
+        type::EntryPoint origin(type::Type_e::Coord, "");
+        origin.coordinates.set_xy(xy.first, xy.second);
+        origin.streetnetwork_params.mode = type::Mode_e::Walking;
+        origin.streetnetwork_params.speed_factor = 1;
+        origins.push_back(origin);
+    }
+    std::vector<type::GeographicalCoord> destinations;
+    for (const auto& xy : {std::make_pair(8., 8.), std::make_pair(1., 1.), std::make_pair(5., 2.)}) {
+        type::GeographicalCoord coord;
+        coord.set_xy(xy.first, xy.second);
+        destinations.push_back(coord);
+    }
+
+    for (const navitia::time_duration radius : {navitia::seconds(10), navitia::seconds(100), navitia::seconds(36000)}) {
+        DijkstraPathFinder path_finder(b.geo_ref);
+        for (const size_t nb_threads : {1, 2, 4}) {
+            StreetNetworkMatrix matrix(b.geo_ref, nb_threads);
+            const auto rows = matrix.compute(origins, destinations, radius);
+            BOOST_REQUIRE_EQUAL(rows.size(), origins.size());
+            for (size_t i = 0; i < origins.size(); ++i) {
+                path_finder.init(origins[i].coordinates, type::Mode_e::Walking, 1);
+                const auto expected = path_finder.get_duration_with_dijkstra(radius, destinations);
+                BOOST_REQUIRE_EQUAL(rows[i].size(), destinations.size());
+                for (size_t j = 0; j < destinations.size(); ++j) {
+                    const auto& element = expected.at(destinations[j].uri());
+                    BOOST_CHECK(rows[i][j].routing_status == element.routing_status);
+                    BOOST_CHECK_EQUAL(rows[i][j].time_duration, element.time_duration);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * The landmarks only speed up the A*, the direct paths must stay the same
+ **/
+BOOST_AUTO_TEST_CASE(direct_path_with_landmarks_same_as_without) {
+    GraphBuilder b;
+    type::Data data;
+    build_data(b, data);
+
+    std::vector<type::EntryPoint> entry_points;
+    for (const auto& xy : {std::make_pair(2., 2.), std::make_pair(0., 5.), std::make_pair(8., 6.),
+                           std::make_pair(1., 1.), std::make_pair(5., 2.)}) {
+        type::EntryPoint entry_point(type::Type_e::Coord, "");
+        entry_point.coordinates.set_xy(xy.first, xy.second);
+        entry_point.streetnetwork_params.mode = type::Mode_e::Walking;
+        entry_point.streetnetwork_params.speed_factor = 1;
+        entry_point.streetnetwork_params.max_duration = navitia::seconds(36000);
+        entry_points.push_back(entry_point);
+    }
+
+    StreetNetwork sn_worker(b.geo_ref);
+    std::vector<Path> expected_paths;
+    for (const auto& origin : entry_points) {
+        for (const auto& destination : entry_points) {
+            expected_paths.push_back(sn_worker.get_direct_path(origin, destination));
+        }
+    }
+
+    b.geo_ref.landmarks[type::Mode_e::Walking] = compute_landmarks(b.geo_ref, type::Mode_e::Walking, 4);
+    const auto& landmarks = b.geo_ref.landmarks[type::Mode_e::Walking];
+    BOOST_REQUIRE_EQUAL(landmarks.nb_landmarks, 4);
+    // only the walking copy of the graph is used by the walking mode
+    BOOST_CHECK_EQUAL(landmarks.durations.size(), 4 * b.geo_ref.nb_vertex_by_mode);
+
+    size_t i = 0;
+    for (const auto& origin : entry_points) {
+        for (const auto& destination : entry_points) {
+            const auto path = sn_worker.get_direct_path(origin, destination);
+            const auto& expected = expected_paths[i++];
+            BOOST_CHECK_EQUAL(path.duration, expected.duration);
+            BOOST_CHECK_EQUAL(path.path_items.size(), expected.path_items.size());
+        }
+    }
+}
+
+/**
+ * The edges are shorter when the speed factor is greater than 1, the bound given by the landmarks must
+ * be too, or the A* misses the shortest paths
+ **/
+BOOST_AUTO_TEST_CASE(direct_path_with_landmarks_and_speed_factor) {
+    GraphBuilder b;
+    type::Data data;
+    build_data(b, data);
+
+    std::vector<type::EntryPoint> entry_points;
+    for (const auto& xy : {std::make_pair(2., 2.), std::make_pair(0., 5.), std::make_pair(8., 6.),
+                           std::make_pair(1., 1.), std::make_pair(5., 2.)}) {
+        type::EntryPoint entry_point(type::Type_e::Coord, "");
+        entry_point.coordinates.set_xy(xy.first, xy.second);
+        entry_point.streetnetwork_params.mode = type::Mode_e::Walking;
+        entry_point.streetnetwork_params.speed_factor = 3;
+        entry_point.streetnetwork_params.max_duration = navitia::seconds(36000);
+        entry_points.push_back(entry_point);
+    }
+
+    StreetNetwork sn_worker(b.geo_ref);
+    std::vector<Path> expected_paths;
+    for (const auto& origin : entry_points) {
+        for (const auto& destination : entry_points) {
+            expected_paths.push_back(sn_worker.get_direct_path(origin, destination));
+        }
+    }
+
+    b.geo_ref.landmarks[type::Mode_e::Walking] = compute_landmarks(b.geo_ref, type::Mode_e::Walking, 4);
+    const auto& landmarks = b.geo_ref.landmarks[type::Mode_e::Walking];
+    BOOST_REQUIRE_EQUAL(landmarks.nb_landmarks, 4);
+
+    // the bound is divided by the speed factor when it is greater than 1 only
+    const std::vector<vertex_t> targets = {b.vertex_map["9_9"]};
+    const auto bound = landmarks.lower_bound(b.vertex_map["0_0"], targets);
+    BOOST_CHECK_EQUAL(landmarks.lower_bound(b.vertex_map["0_0"], targets, 0.5), bound);
+    BOOST_CHECK_EQUAL(landmarks.lower_bound(b.vertex_map["0_0"], targets, 3), bound * (1.f / 3));
+
+    size_t i = 0;
+    for (const auto& origin : entry_points) {
+        for (const auto& destination : entry_points) {
+            const auto path = sn_worker.get_direct_path(origin, destination);
+            const auto& expected = expected_paths[i++];
+            BOOST_CHECK_EQUAL(path.duration, expected.duration);
+            BOOST_CHECK_EQUAL(path.path_items.size(), expected.path_items.size());
+        }
+    }
+}
+
+/**
+ * The path finders must give the same distances, predecessors and paths on the search graph
+ **/
+BOOST_AUTO_TEST_CASE(search_graph_same_results_as_graph) {
+    GraphBuilder b;
+    type::Data data;
+    build_data(b, data);
+    BOOST_REQUIRE(!b.geo_ref.has_search_graph());
+
+    type::GeographicalCoord start;
+    start.set_xy(2., 2.);
+    type::EntryPoint origin(type::Type_e::Coord, "");
+    origin.coordinates = start;
+    origin.streetnetwork_params.mode = type::Mode_e::Walking;
+    origin.streetnetwork_params.speed_factor = 1;
+    origin.streetnetwork_params.max_duration = navitia::seconds(36000);
+    type::EntryPoint destination = origin;
+    destination.coordinates.set_xy(8., 6.);
+
+    auto const target_idx = data.pt_data->stop_points.front()->idx;
+    DijkstraPathFinder worker(b.geo_ref);
+    worker.init(start, type::Mode_e::Walking, 1);
+    auto distance = worker.get_distance(target_idx);
+    BOOST_REQUIRE_NE(distance, bt::pos_infin);
+    computation_results expected{distance, worker};
+    StreetNetwork sn_worker(b.geo_ref);
+    const auto expected_path = sn_worker.get_direct_path(origin, destination);
+    BOOST_REQUIRE(!expected_path.path_items.empty());
+
+    b.geo_ref.build_search_graph();
+    BOOST_REQUIRE(b.geo_ref.has_search_graph());
+    BOOST_CHECK_EQUAL(boost::num_edges(b.geo_ref.search_graph), boost::num_edges(b.geo_ref.graph));
+
+    worker.init(start, type::Mode_e::Walking, 1);
+    distance = worker.get_distance(target_idx);
+    computation_results res{distance, worker};
+    BOOST_CHECK(expected == res);
+
+    const auto path = sn_worker.get_direct_path(origin, destination);
+    BOOST_CHECK_EQUAL(path.duration, expected_path.duration);
+    BOOST_REQUIRE_EQUAL(path.path_items.size(), expected_path.path_items.size());
+    for (size_t i = 0; i < path.path_items.size(); ++i) {
+        BOOST_CHECK_EQUAL(path.path_items[i].way_idx, expected_path.path_items[i].way_idx);
+        BOOST_CHECK_EQUAL(path.path_items[i].duration, expected_path.path_items[i].duration);
+    }
+
+    // the graph is modified, the path finders are back on it until the search graph is built again
+    b.geo_ref.init();
+    BOOST_CHECK(!b.geo_ref.has_search_graph());
+}
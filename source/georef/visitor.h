@@ -35,6 +35,7 @@ www.navitia.io
 
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <boost/graph/astar_search.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace navitia {
@@ -70,14 +71,19 @@ struct target_all_visitor : virtual public Base {
     std::vector<vertex_t> destinations;
     size_t nbFound = 0;
 
+    // the destinations are sorted and deduplicated, so that a vertex is counted only once
     target_all_visitor(const std::vector<vertex_t>& destinations)
-        : destinations(destinations.begin(), destinations.end()) {}
+        : destinations(destinations.begin(), destinations.end()) {
+        std::sort(this->destinations.begin(), this->destinations.end());
+        this->destinations.erase(std::unique(this->destinations.begin(), this->destinations.end()),
+                                 this->destinations.end());
+    }
 
     target_all_visitor(const target_all_visitor& other) = default;
 
     template <typename graph_type>
     void finish_vertex(vertex_t u, const graph_type&) {
-        if (std::find(destinations.begin(), destinations.end(), u) != destinations.end()) {
+        if (std::binary_search(destinations.begin(), destinations.end(), u)) {
             nbFound++;
             if (nbFound == destinations.size()) {
                 throw DestinationFound();
@@ -121,6 +127,7 @@ struct distance_or_target_visitor : virtual public distance_visitor<Base>, virtu
 
 using dijkstra_distance_visitor = distance_visitor<boost::dijkstra_visitor<>>;
 using dijkstra_target_all_visitor = target_all_visitor<boost::dijkstra_visitor<>>;
+using dijkstra_distance_or_target_visitor = distance_or_target_visitor<boost::dijkstra_visitor<>>;
 
 using astar_distance_or_target_visitor = distance_or_target_visitor<boost::astar_visitor<>>;
 
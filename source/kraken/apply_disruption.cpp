@@ -875,6 +875,7 @@ struct delete_impacts_visitor : public apply_impacts_visitor {
     // other disruptions after
     void operator()(nt::MetaVehicleJourney* mvj, nt::Route* /*r*/ = nullptr) override {
         mvj->remove_impact(impact);
+        pt_data.mark_rt_modified_routes(*mvj);
         for (auto& vj : mvj->get_base_vj()) {
             // Time to reset the vj
             // We re-activate base vj for every realtime level by reseting base vj's vp to base
@@ -31,11 +31,15 @@ www.navitia.io
 #include "configuration.h"
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/range/algorithm_ext/erase.hpp>
 #include <boost/optional.hpp>
 
 #include <fstream>
 #include <iostream>
 #include "utils/functions.h"
+#include "routing/mc_raptor.h"
 
 namespace po = boost::program_options;
 
@@ -76,6 +80,24 @@ po::options_description get_options_description(const boost::optional<std::strin
              po::value<bool>()->default_value(*display_contributors) : po::value<bool>()->default_value(false),
          "display all contributors in feed publishers")
         ("GENERAL.raptor_cache_size", po::value<int>()->default_value(10), "maximum number of stored raptor caches")
+        ("GENERAL.raptor_profile_mode", po::value<bool>()->default_value(false),
+                                        "compute the journeys of a timeframe in one range raptor (rRAPTOR) sweep")
+        ("GENERAL.raptor_snd_pass_threads", po::value<int>()->default_value(1),
+                                            "number of threads running the raptor second pass of a request")
+        ("GENERAL.raptor_mc_mode", po::value<bool>()->default_value(false),
+                                   "compute the clockwise journeys with the multi-criteria raptor (McRAPTOR)")
+        ("GENERAL.raptor_mc_criteria", po::value<std::string>()->default_value(""),
+                                       "comma separated criteria of the multi-criteria raptor")
+        ("GENERAL.raptor_mc_max_bag_size", po::value<int>()->default_value(16),
+                                           "maximum number of labels by stop point of the multi-criteria raptor")
+        ("GENERAL.raptor_mc_time_budget", po::value<int>()->default_value(0),
+                                          "time budget in ms of a multi-criteria raptor (0 for no limit)")
+        ("GENERAL.heat_map_threads", po::value<int>()->default_value(1),
+                                     "number of threads rasterizing the grid of a heat map")
+        ("GENERAL.street_network_matrix_threads", po::value<int>()->default_value(1),
+                                                  "number of threads computing the rows of a street network matrix")
+        ("GENERAL.street_network_landmarks", po::value<int>()->default_value(0),
+                                             "number of landmarks speeding up the bike and car direct paths (0 to disable)")
         ("GENERAL.log_level", po::value<std::string>(), "log level of kraken")
         ("GENERAL.log_format", po::value<std::string>()->default_value("[%D{%y-%m-%d %H:%M:%S,%q}] [%p] [%x] - %m %b:%L  %n"), "log format")
 
@@ -326,6 +348,105 @@ size_t Configuration::raptor_cache_size() const {
     return size_t(raptor_cache_size);
 }
 
+bool Configuration::raptor_profile_mode() const {
+    if (!vm.count("GENERAL.raptor_profile_mode")) {
+        return false;
+    }
+    return vm["GENERAL.raptor_profile_mode"].as<bool>();
+}
+
+size_t Configuration::raptor_snd_pass_threads() const {
+    if (!vm.count("GENERAL.raptor_snd_pass_threads")) {
+        return 1;
+    }
+    int raptor_snd_pass_threads = vm["GENERAL.raptor_snd_pass_threads"].as<int>();
+    if (raptor_snd_pass_threads < 1) {
+        throw std::invalid_argument("raptor_snd_pass_threads must be strictly positive");
+    }
+    return size_t(raptor_snd_pass_threads);
+}
+
+bool Configuration::raptor_mc_mode() const {
+    if (!vm.count("GENERAL.raptor_mc_mode")) {
+        return false;
+    }
+    return vm["GENERAL.raptor_mc_mode"].as<bool>();
+}
+
+std::vector<std::string> Configuration::raptor_mc_criteria() const {
+    std::vector<std::string> criteria;
+    if (!vm.count("GENERAL.raptor_mc_criteria")) {
+        return criteria;
+    }
+    const auto& value = vm["GENERAL.raptor_mc_criteria"].as<std::string>();
+    boost::split(criteria, value, boost::is_any_of(", "), boost::token_compress_on);
+    boost::remove_erase_if(criteria, [](const std::string& criterion) { return criterion.empty(); });
+    if (criteria.size() > routing::McRaptorParams::max_criteria) {
+        throw std::invalid_argument("raptor_mc_criteria must have at most "
+                                    + std::to_string(routing::McRaptorParams::max_criteria) + " criteria");
+    }
+    for (const auto& criterion : criteria) {
+        // throws on an unknown name
+        routing::make_mc_criterion(criterion);
+    }
+    return criteria;
+}
+
+size_t Configuration::raptor_mc_max_bag_size() const {
+    if (!vm.count("GENERAL.raptor_mc_max_bag_size")) {
+        return 16;
+    }
+    int raptor_mc_max_bag_size = vm["GENERAL.raptor_mc_max_bag_size"].as<int>();
+    if (raptor_mc_max_bag_size < 1) {
+        throw std::invalid_argument("raptor_mc_max_bag_size must be strictly positive");
+    }
+    return size_t(raptor_mc_max_bag_size);
+}
+
+int Configuration::raptor_mc_time_budget() const {
+    if (!vm.count("GENERAL.raptor_mc_time_budget")) {
+        return 0;
+    }
+    int raptor_mc_time_budget = vm["GENERAL.raptor_mc_time_budget"].as<int>();
+    if (raptor_mc_time_budget < 0) {
+        throw std::invalid_argument("raptor_mc_time_budget must be positive");
+    }
+    return raptor_mc_time_budget;
+}
+
+size_t Configuration::heat_map_threads() const {
+    if (!vm.count("GENERAL.heat_map_threads")) {
+        return 1;
+    }
+    int heat_map_threads = vm["GENERAL.heat_map_threads"].as<int>();
+    if (heat_map_threads < 1) {
+        throw std::invalid_argument("heat_map_threads must be strictly positive");
+    }
+    return size_t(heat_map_threads);
+}
+
+size_t Configuration::street_network_matrix_threads() const {
+    if (!vm.count("GENERAL.street_network_matrix_threads")) {
+        return 1;
+    }
+    int street_network_matrix_threads = vm["GENERAL.street_network_matrix_threads"].as<int>();
+    if (street_network_matrix_threads < 1) {
+        throw std::invalid_argument("street_network_matrix_threads must be strictly positive");
+    }
+    return size_t(street_network_matrix_threads);
+}
+
+size_t Configuration::street_network_landmarks() const {
+    if (!vm.count("GENERAL.street_network_landmarks")) {
+        return 0;
+    }
+    int street_network_landmarks = vm["GENERAL.street_network_landmarks"].as<int>();
+    if (street_network_landmarks < 0) {
+        throw std::invalid_argument("street_network_landmarks cannot be negative");
+    }
+    return size_t(street_network_landmarks);
+}
+
 boost::optional<std::string> Configuration::log_level() const {
     boost::optional<std::string> result;
     if (this->vm.count("GENERAL.log_level") > 0) {
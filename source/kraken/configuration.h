@@ -78,6 +78,15 @@ public:
     int kirin_retry_timeout() const;
     bool display_contributors() const;
     size_t raptor_cache_size() const;
+    bool raptor_profile_mode() const;
+    size_t raptor_snd_pass_threads() const;
+    bool raptor_mc_mode() const;
+    std::vector<std::string> raptor_mc_criteria() const;
+    size_t raptor_mc_max_bag_size() const;
+    int raptor_mc_time_budget() const;
+    size_t heat_map_threads() const;
+    size_t street_network_matrix_threads() const;
+    size_t street_network_landmarks() const;
     int core_file_size_limit() const;
     int slow_request_duration() const;
     boost::optional<std::string> log_level() const;
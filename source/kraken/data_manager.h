@@ -46,6 +46,12 @@ www.navitia.io
 #include <memory>
 #include <iostream>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
 
 template <typename Data>
 void data_deleter(const Data* data) {
@@ -57,6 +63,53 @@ void data_deleter(const Data* data) {
 #endif
 }
 
+using BuildStage = std::pair<std::string, std::function<void()>>;
+using BuildStageObserver = std::function<void(const std::string&, double)>;
+
+/**
+ * Run independent build stages of a Data concurrently
+ *
+ * The stages must only write disjoint parts of the Data. The calling thread runs the first one,
+ * the others run on their own thread. The duration of each stage (in seconds) is given to
+ * observe_duration. If a stage throws, the exception is rethrown once all the stages are done.
+ */
+inline void run_build_stages(const std::vector<BuildStage>& stages, const BuildStageObserver& observe_duration) {
+    auto run_stage = [&observe_duration](const BuildStage& stage) {
+        const auto start = std::chrono::steady_clock::now();
+        stage.second();
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
+        LOG4CPLUS_DEBUG(logger, "build stage " << stage.first << " done in " << duration.count() << "s");
+        if (observe_duration) {
+            observe_duration(stage.first, duration.count());
+        }
+    };
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < stages.size(); ++i) {
+        futures.push_back(std::async(std::launch::async, run_stage, std::cref(stages[i])));
+    }
+    std::exception_ptr error;
+    if (!stages.empty()) {
+        try {
+            run_stage(stages.front());
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
 template <typename Data>
 class DataManager {
     boost::shared_ptr<const Data> current_data;
@@ -80,6 +133,8 @@ private:
 
     std::unique_ptr<boost::shared_mutex> write = std::make_unique<boost::shared_mutex>();
 
+    BuildStageObserver build_stage_observer;
+
 public:
     DataManager(bool aggressive_memory_decommit = false) : current_data(create_data(0)), data_identifier(0) {
         if (aggressive_memory_decommit) {
@@ -87,6 +142,9 @@ public:
         }
     }
 
+    // called with the duration of each stage built after the loading of the data
+    void set_build_stage_observer(BuildStageObserver observer) { build_stage_observer = std::move(observer); }
+
     void set_data(const Data* d) { set_data(create_ptr(d)); }
     void set_data(boost::shared_ptr<const Data>&& data) {
         if (!data) {
@@ -112,7 +170,8 @@ public:
               const boost::optional<std::string>& chaos_database = boost::none,
               const std::vector<std::string>& contributors = {},
               const size_t raptor_cache_size = 10,
-              const size_t chaos_batch_size = 1000000) {
+              const size_t chaos_batch_size = 1000000,
+              const size_t nb_street_network_landmarks = 0) {
         // Add logger
         log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
 
@@ -130,13 +189,14 @@ public:
         }
 
         // load disruptions from database
+        bool disruptions_loaded = false;
         if (chaos_database != boost::none) {
             // If we catch a bdd broken connection, we do nothing (Just a log),
             // because data is still clean, unlike other cases where we have
             // to reload the data
             try {
                 data->load_disruptions(*chaos_database, chaos_batch_size, contributors);
-                data->build_autocomplete_partial();
+                disruptions_loaded = true;
             } catch (const navitia::data::disruptions_broken_connection&) {
                 LOG4CPLUS_WARN(logger, "Load data without disruptions");
             } catch (const navitia::data::disruptions_loading_error&) {
@@ -149,11 +209,21 @@ public:
                 }
             }
         }
-        data->build_relations();
-        // Build Raptor Data
-        data->build_raptor(raptor_cache_size);
-        // Build proximity list NN index
-        data->build_proximity_list();
+
+        // The relations, the Raptor data, the proximity lists (NN index) and the autocomplete
+        // only read the pt referential and each write their own part of the data
+        std::vector<BuildStage> stages = {
+            {"raptor", [&]() { data->build_raptor(raptor_cache_size); }},
+            {"relations", [&]() { data->build_relations(); }},
+            {"proximity_list", [&]() { data->build_proximity_list(); }},
+        };
+        if (disruptions_loaded) {
+            stages.emplace_back("autocomplete", [&]() { data->build_autocomplete_partial(); });
+        }
+        if (nb_street_network_landmarks > 0) {
+            stages.emplace_back("landmarks", [&]() { data->build_landmarks(nb_street_network_landmarks); });
+        }
+        run_build_stages(stages, build_stage_observer);
         data->loading = false;
         data->loaded = true;
 
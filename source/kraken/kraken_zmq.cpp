@@ -117,6 +117,16 @@ int main(int argn, char** argv) {
 
     set_core_file_size_limit(conf.core_file_size_limit(), logger);
 
+    // the planner is only built on the first request, its settings are checked before accepting any
+    try {
+        conf.raptor_mc_criteria();
+        conf.raptor_mc_max_bag_size();
+        conf.raptor_mc_time_budget();
+    } catch (const std::invalid_argument& e) {
+        LOG4CPLUS_ERROR(logger, "invalid configuration: " << e.what());
+        return 1;
+    }
+
     boost::thread_group threads;
     // Prepare our context and sockets
     zmq::context_t context(1);
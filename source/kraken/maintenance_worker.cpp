@@ -163,8 +163,8 @@ void MaintenanceWorker::load_data() {
     auto contributors = conf.rt_topics();
     LOG4CPLUS_INFO(logger, "Loading database from file: " + database);
     auto start = pt::microsec_clock::universal_time();
-    bool data_loaded =
-        this->data_manager.load(database, chaos_database, contributors, conf.raptor_cache_size(), chaos_batch_size);
+    bool data_loaded = this->data_manager.load(database, chaos_database, contributors, conf.raptor_cache_size(),
+                                               chaos_batch_size, conf.street_network_landmarks());
     if (data_loaded) {
         auto data = data_manager.get_data();
         data->is_realtime_loaded = false;
@@ -430,18 +430,24 @@ void MaintenanceWorker::handle_rt_in_batch(const std::vector<AmqpClient::Envelop
         LOG4CPLUS_DEBUG(logger, "Number of RT entity really applied in this message batch: " << applied_entity_count);
     }
     if (data) {
-        LOG4CPLUS_INFO(logger, "rebuilding relations");
-        data->build_relations();
+        LOG4CPLUS_INFO(logger, "cleaning weak impacts");
+        data->pt_data->clean_weak_impacts();
+        LOG4CPLUS_INFO(logger, "rebuilding relations, data raptor and proximity lists");
+        const auto current_data = data_manager.get_data();
+        std::vector<BuildStage> stages = {
+            {"raptor", [&]() { data->build_raptor(*current_data, conf.raptor_cache_size()); }},
+            {"relations", [&]() { data->build_relations(); }},
+            // the street network is shared with the current data, only the pt proximity lists are rebuilt
+            {"proximity_list", [&]() { data->pt_data->build_proximity_list(); }},
+        };
         if (autocomplete_rebuilding_activated) {
             LOG4CPLUS_INFO(logger, "rebuilding autocomplete");
-            data->build_autocomplete_partial();
+            stages.emplace_back("autocomplete", [&]() { data->build_autocomplete_partial(); });
         }
-        LOG4CPLUS_INFO(logger, "cleaning weak impacts");
-        data->pt_data->clean_weak_impacts();
-        LOG4CPLUS_INFO(logger, "rebuilding data raptor");
-        data->build_raptor(conf.raptor_cache_size());
-        data->build_proximity_list();
-        data->warmup(*data_manager.get_data());
+        run_build_stages(stages, [&](const std::string& stage, double duration) {
+            this->metrics.observe_data_build(stage, duration);
+        });
+        data->warmup(*current_data);
         data->set_last_rt_data_loaded(pt::microsec_clock::universal_time());
         data_manager.set_data(std::move(data));
 
@@ -592,6 +598,9 @@ MaintenanceWorker::MaintenanceWorker(DataManager<type::Data>& data_manager,
       logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("background"))),
       conf(std::move(conf)),
       metrics(metrics),
-      next_try_realtime_loading(pt::microsec_clock::universal_time()) {}
+      next_try_realtime_loading(pt::microsec_clock::universal_time()) {
+    data_manager.set_build_stage_observer(
+        [this](const std::string& stage, double duration) { this->metrics.observe_data_build(stage, duration); });
+}
 
 }  // namespace navitia
@@ -109,6 +109,15 @@ Metrics::Metrics(const boost::optional<std::string>& endpoint, const std::string
                                  .Register(*registry);
     this->in_flight = &in_flight_family.Add({});
 
+    auto& data_build_family = prometheus::BuildHistogram()
+                                  .Name("kraken_data_build_duration_seconds")
+                                  .Help("duration of the build stages run after loading data or applying realtime")
+                                  .Labels({{"coverage", coverage}})
+                                  .Register(*registry);
+    for (const auto& stage : {"relations", "raptor", "proximity_list", "autocomplete", "landmarks"}) {
+        this->data_build_histogram[stage] = &data_build_family.Add({{"stage", stage}}, create_fixed_duration_buckets());
+    }
+
     auto& cache_miss_family = prometheus::BuildGauge()
                                   .Name("kraken_next_stop_time_cache_miss")
                                   .Help("Number of cache miss for the next stop_time in raptor")
@@ -215,6 +224,19 @@ void Metrics::observe_data_cloning(double duration) const {
     this->data_cloning_histogram->Observe(duration);
 }
 
+void Metrics::observe_data_build(const std::string& stage, double duration) const {
+    if (!registry) {
+        return;
+    }
+    auto it = this->data_build_histogram.find(stage);
+    if (it != std::end(this->data_build_histogram)) {
+        it->second->Observe(duration);
+    } else {
+        auto logger = log4cplus::Logger::getInstance("metrics");
+        LOG4CPLUS_WARN(logger, "data build stage " << stage << " not found in metrics");
+    }
+}
+
 void Metrics::observe_handle_rt(double duration) const {
     if (!registry) {
         return;
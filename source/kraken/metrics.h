@@ -40,6 +40,7 @@ www.navitia.io
 
 #include <memory>
 #include <map>
+#include <string>
 
 // forward declare
 namespace prometheus {
@@ -67,6 +68,7 @@ protected:
     std::unique_ptr<prometheus::Exposer> exposer;
     std::shared_ptr<prometheus::Registry> registry;
     std::map<pbnavitia::API, prometheus::Histogram*> request_histogram;
+    std::map<std::string, prometheus::Histogram*> data_build_histogram;
     prometheus::Gauge* in_flight;
     prometheus::Histogram* data_loading_histogram;
     prometheus::Histogram* data_cloning_histogram;
@@ -86,6 +88,7 @@ public:
 
     void observe_data_loading(double duration) const;
     void observe_data_cloning(double duration) const;
+    void observe_data_build(const std::string& stage, double duration) const;
     void observe_handle_rt(double duration) const;
     void observe_retrieve_rt_message_duration(double duration) const;
     void observe_retrieved_rt_message_count(size_t count) const;
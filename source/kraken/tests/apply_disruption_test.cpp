@@ -42,6 +42,8 @@ www.navitia.io
 #include "routing/raptor.h"
 #include "type/pb_converter.h"
 
+#include <boost/range/algorithm/equal.hpp>
+
 struct logger_initialized {
     logger_initialized() { navitia::init_logger(); }
 };
@@ -5034,3 +5036,122 @@ BOOST_AUTO_TEST_CASE(complex_impact_with_rail_section_reduced_service_first_stop
     BOOST_REQUIRE_EQUAL(b.get<nt::StopPoint>("stopH")->get_impacts().size(), 0);
     BOOST_REQUIRE_EQUAL(b.get<nt::StopPoint>("stopI")->get_impacts().size(), 0);
 }
+
+BOOST_AUTO_TEST_CASE(incremental_data_raptor_after_disruption) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("A")("stopA1", "10:00"_t)("stopA2", "11:00"_t)("stopA3", "12:00"_t);
+        b.vj("A")("stopA1", "10:30"_t)("stopA2", "11:30"_t)("stopA3", "12:30"_t);
+        b.vj("B")("stopB1", "10:00"_t)("stopB2", "11:00"_t);
+        b.vj("B")("stopB1", "09:00"_t)("stopB2", "10:00"_t);
+    });
+    BOOST_REQUIRE(b.data->pt_data->rt_modified_routes.empty());
+
+    navitia::apply_disruption(b.impact(nt::RTLevel::RealTime, "Line A closed")
+                                  .severity(nt::disruption::Effect::NO_SERVICE)
+                                  .on(nt::Type_e::Line, "A", *b.data->pt_data)
+                                  .application_periods(btp("20120615T0000"_dt, "20120616T0000"_dt))
+                                  .get_disruption(),
+                              *b.data->pt_data, *b.data->meta);
+
+    // only the route of the line A has been modified
+    const auto& rt_modified_routes = b.data->pt_data->rt_modified_routes;
+    BOOST_REQUIRE_EQUAL(rt_modified_routes.size(), 1);
+    BOOST_CHECK_EQUAL(b.data->pt_data->routes[*rt_modified_routes.begin()]->line->uri, "A");
+
+    navitia::routing::dataRAPTOR incremental;
+    incremental.load(*b.data->pt_data, *b.data->dataRaptor, rt_modified_routes);
+    navitia::routing::dataRAPTOR full;
+    full.load(*b.data->pt_data);
+
+    // the incremental build must be the same as a full build
+    BOOST_REQUIRE_EQUAL(incremental.jp_container.nb_jps(), full.jp_container.nb_jps());
+    for (const auto level : {nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime}) {
+        BOOST_CHECK(incremental.jp_validity_patterns[level] == full.jp_validity_patterns[level]);
+    }
+    for (const auto jpp : full.jp_container.get_jpps()) {
+        for (const auto stop_event : {navitia::routing::StopEvent::pick_up, navitia::routing::StopEvent::drop_off}) {
+            const auto full_range = full.next_stop_time_data.stop_time_range_forward(jpp.first, stop_event);
+            const auto incremental_range =
+                incremental.next_stop_time_data.stop_time_range_forward(jpp.first, stop_event);
+            BOOST_CHECK(boost::equal(full_range, incremental_range));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cloned_data_shares_the_street_network) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("A")("stopA1", "10:00"_t)("stopA2", "11:00"_t);
+        b.vj("B")("stopB1", "10:00"_t)("stopB2", "11:00"_t);
+    });
+    auto* admin = new navitia::georef::Admin();
+    admin->uri = "admin";
+    admin->idx = 0;
+    b.data->geo_ref->admins.push_back(admin);
+    b.manage_admin();
+    b.data->pt_data->main_stop_areas_by_admin[admin->idx].push_back(b.get<nt::StopArea>("stopA1"));
+
+    nt::Data clone;
+    clone.clone_from(*b.data);
+
+    BOOST_CHECK_EQUAL(clone.geo_ref.get(), b.data->geo_ref.get());
+    BOOST_REQUIRE_EQUAL(clone.pt_data->stop_areas.size(), b.data->pt_data->stop_areas.size());
+    for (const auto* sa : clone.pt_data->stop_areas) {
+        BOOST_REQUIRE_EQUAL(sa->admin_list.size(), 1);
+        BOOST_CHECK_EQUAL(sa->admin_list.front(), admin);
+    }
+    for (const auto* sp : clone.pt_data->stop_points) {
+        BOOST_REQUIRE_EQUAL(sp->admin_list.size(), 1);
+        BOOST_CHECK_EQUAL(sp->admin_list.front(), admin);
+    }
+
+    // the main stop areas of the admin are the cloned ones
+    const auto& main_stop_areas = clone.pt_data->main_stop_areas(*admin);
+    BOOST_REQUIRE_EQUAL(main_stop_areas.size(), 1);
+    BOOST_CHECK_EQUAL(main_stop_areas.front(), clone.pt_data->stop_areas_map["stopA1"]);
+    BOOST_CHECK_NE(main_stop_areas.front(), b.get<nt::StopArea>("stopA1"));
+}
+
+BOOST_AUTO_TEST_CASE(warmup_copies_the_cache_of_the_reused_journey_patterns) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("A")("stopA1", "10:00"_t)("stopA2", "11:00"_t)("stopA3", "12:00"_t);
+        b.vj("B")("stopB1", "10:00"_t)("stopB2", "11:00"_t);
+        b.vj("B")("stopB1", "09:00"_t)("stopB2", "10:00"_t);
+        b.frequency_vj("C", "08:00"_t, "18:00"_t, "01:00"_t)("stopC1", "08:00"_t)("stopC2", "08:30"_t);
+    });
+    const auto from = navitia::DateTimeUtils::set(1, "08:00"_t);
+    const auto accessibilite_params = nt::AccessibiliteParams();
+    for (const auto level : {nt::RTLevel::Base, nt::RTLevel::RealTime}) {
+        b.data->dataRaptor->cached_next_st_manager->load(from, level, accessibilite_params);
+    }
+
+    navitia::apply_disruption(b.impact(nt::RTLevel::RealTime, "Line A closed")
+                                  .severity(nt::disruption::Effect::NO_SERVICE)
+                                  .on(nt::Type_e::Line, "A", *b.data->pt_data)
+                                  .application_periods(btp("20120615T0000"_dt, "20120616T0000"_dt))
+                                  .get_disruption(),
+                              *b.data->pt_data, *b.data->meta);
+
+    navitia::routing::dataRAPTOR incremental;
+    incremental.load(*b.data->pt_data, *b.data->dataRaptor, b.data->pt_data->rt_modified_routes);
+    const auto& previous_manager = *b.data->dataRaptor->cached_next_st_manager;
+    const auto previous_nb_calls = previous_manager.get_nb_calls();
+    incremental.warmup(*b.data->dataRaptor);
+    BOOST_CHECK(incremental.warmup_from == nullptr);
+    // the previous caches are given to the creator, the previous lru is not called during the warmup
+    BOOST_CHECK_EQUAL(previous_manager.get_nb_calls(), previous_nb_calls);
+    const auto nb_cache_miss = incremental.cached_next_st_manager->get_nb_cache_miss();
+    navitia::routing::dataRAPTOR full;
+    full.load(*b.data->pt_data);
+
+    // the warmed up caches must be the same as the ones computed from scratch
+    for (const auto level : {nt::RTLevel::Base, nt::RTLevel::RealTime}) {
+        const auto incremental_cache = incremental.cached_next_st_manager->load(from, level, accessibilite_params);
+        const auto full_cache = full.cached_next_st_manager->load(from, level, accessibilite_params);
+        for (const auto jpp : full.jp_container.get_jpps()) {
+            BOOST_CHECK(boost::equal(full_cache->departures(jpp.first), incremental_cache->departures(jpp.first)));
+            BOOST_CHECK(boost::equal(full_cache->arrivals(jpp.first), incremental_cache->arrivals(jpp.first)));
+        }
+    }
+    // nothing is computed by the requests after the warmup
+    BOOST_CHECK_EQUAL(incremental.cached_next_st_manager->get_nb_cache_miss(), nb_cache_miss);
+}
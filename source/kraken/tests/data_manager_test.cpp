@@ -35,6 +35,9 @@ www.navitia.io
 
 #include <boost/test/unit_test.hpp>
 #include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
 
 namespace test {
 
@@ -47,6 +50,7 @@ public:
     void build_relations() {}
     void build_proximity_list() {}
     void build_autocomplete_partial() {}
+    void build_landmarks(size_t) {}
     mutable std::atomic<bool> loading;
     mutable std::atomic<bool> loaded;
     mutable std::atomic<bool> is_connected_to_rabbitmq;
@@ -125,4 +129,28 @@ BOOST_AUTO_TEST_CASE(destructor_not_called) {
     BOOST_CHECK(data_manager.get_data());
 }
 
+BOOST_AUTO_TEST_CASE(load_observes_build_stages) {
+    DataManager<test::Data> data_manager;
+    std::mutex mutex;
+    std::multiset<std::string> stages;
+    data_manager.set_build_stage_observer([&](const std::string& stage, double) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stages.insert(stage);
+    });
+
+    BOOST_CHECK(data_manager.load("fake path"));
+    BOOST_CHECK((stages == std::multiset<std::string>{"proximity_list", "raptor", "relations"}));
+}
+
+BOOST_AUTO_TEST_CASE(run_build_stages_rethrows_after_all_stages) {
+    std::atomic<int> nb_done(0);
+    std::vector<BuildStage> stages = {
+        {"first", [&]() { ++nb_done; }},
+        {"failing", []() { throw std::runtime_error("stage failed"); }},
+        {"last", [&]() { ++nb_done; }},
+    };
+    BOOST_CHECK_THROW(run_build_stages(stages, {}), std::runtime_error);
+    BOOST_CHECK_EQUAL(nb_done, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -400,8 +400,21 @@ void Worker::init_worker_data(const navitia::type::Data* data,
                               const std::string language) {
     //@TODO should be done in data_manager
     if (data->data_identifier != this->last_data_identifier || !planner) {
-        planner = std::make_unique<routing::RAPTOR>(*data);
+        // the planner is only replaced once it is fully set up
+        auto new_planner = std::make_unique<routing::RAPTOR>(*data);
+        new_planner->profile_mode = conf.raptor_profile_mode();
+        new_planner->nb_snd_pass_threads = conf.raptor_snd_pass_threads();
+        new_planner->nb_heat_map_threads = conf.heat_map_threads();
+        new_planner->mc_mode = conf.raptor_mc_mode();
+        for (const auto& criterion : conf.raptor_mc_criteria()) {
+            new_planner->mc_params.criteria.push_back(routing::make_mc_criterion(criterion));
+        }
+        new_planner->mc_params.max_bag_size = conf.raptor_mc_max_bag_size();
+        new_planner->mc_params.time_budget = std::chrono::milliseconds(conf.raptor_mc_time_budget());
+        planner = std::move(new_planner);
         street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref);
+        street_network_matrix =
+            std::make_unique<georef::StreetNetworkMatrix>(*data->geo_ref, conf.street_network_matrix_threads());
         this->last_data_identifier = data->data_identifier;
         LOG4CPLUS_INFO(logger, "Instanciate planner");
     }
@@ -1027,32 +1040,27 @@ void Worker::street_network_routing_matrix(const pbnavitia::StreetNetworkRouting
         }
     }
 
+    std::vector<type::EntryPoint> origins;
     for (const auto& origin : request.origins()) {
-        type::EntryPoint entry_point;
         try {
-            entry_point =
-                make_sn_entry_point(origin.place(), request.mode(), request.speed(), request.max_duration(), *data);
+            origins.push_back(
+                make_sn_entry_point(origin.place(), request.mode(), request.speed(), request.max_duration(), *data));
         } catch (const navitia::coord_conversion_exception& e) {
             this->pb_creator.fill_pb_error(pbnavitia::Error::bad_format, e.what());
             return;
         }
+    }
 
-        street_network_worker->departure_path_finder.init(entry_point.coordinates,
-                                                          entry_point.streetnetwork_params.mode,
-                                                          entry_point.streetnetwork_params.speed_factor);
-        auto nearest = street_network_worker->departure_path_finder.get_duration_with_dijkstra(
-            navitia::time_duration::from_boost_duration(boost::posix_time::seconds(request.max_duration())),
-            dest_coords);
+    const auto matrix = street_network_matrix->compute(
+        origins, dest_coords,
+        navitia::time_duration::from_boost_duration(boost::posix_time::seconds(request.max_duration())));
 
+    for (const auto& durations : matrix) {
         auto* row = this->pb_creator.mutable_sn_routing_matrix()->add_rows();
-        for (auto coord : dest_coords) {
+        for (const auto& routing_element : durations) {
             auto* k = row->add_routing_response();
-            auto it = nearest.find(coord.uri());
-            if (it == nearest.end()) {
-                throw navitia::recoverable_exception("Cannot find object: " + coord.uri());
-            }
-            k->set_duration(it->second.time_duration.total_seconds());
-            switch (it->second.routing_status) {
+            k->set_duration(routing_element.time_duration.total_seconds());
+            switch (routing_element.routing_status) {
                 case georef::RoutingStatus_e::reached:
                     k->set_routing_status(pbnavitia::RoutingStatus::reached);
                     break;
@@ -38,6 +38,7 @@ struct RAPTOR;
 }  // namespace navitia
 
 #include "georef/street_network.h"
+#include "georef/street_network_matrix.h"
 #include "type/type.pb.h"
 #include "type/response.pb.h"
 #include "type/request.pb.h"
@@ -78,6 +79,7 @@ class Worker {
 private:
     std::unique_ptr<navitia::routing::RAPTOR> planner;
     std::unique_ptr<navitia::georef::StreetNetwork> street_network_worker;
+    std::unique_ptr<navitia::georef::StreetNetworkMatrix> street_network_matrix;
 
     const kraken::Configuration conf;
     log4cplus::Logger logger;
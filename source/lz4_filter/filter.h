@@ -37,6 +37,16 @@ www.navitia.io
 #include <boost/iostreams/write.hpp>
 #include <boost/iostreams/read.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/iostreams/categories.hpp>
+#include "type/worker_pool.h"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
 
 using LZ4Exception = std::exception;
 
@@ -126,3 +136,365 @@ public:
         return output_size;
     }
 };
+
+/*
+ * Chunked LZ4 container, seekable thanks to the index of its chunks at the end of the file:
+ *
+ *   header:  u32 magic, u32 version, u32 chunk size (maximum raw size of a chunk)
+ *   chunks:  the LZ4 blocks, one after the other
+ *   index:   for each chunk, u64 offset of the block in the file, u32 compressed size, u32 raw size
+ *   trailer: u64 offset of the index, u32 number of chunks, u32 magic
+ *
+ * All the integers are little endian. The chunks being independent, they are compressed and
+ * decompressed on several threads. The files written by LZ4Compressor start with the size of
+ * their first chunk, that is far below the magic, so both formats can be told apart.
+ */
+namespace lz4_chunked {
+
+constexpr uint32_t magic = 0x345a4c4e;  // "NLZ4"
+constexpr uint32_t version = 1;
+constexpr size_t header_size = 12;
+constexpr size_t index_entry_size = 16;
+constexpr size_t trailer_size = 16;
+constexpr size_t default_chunk_size = 1024 * 1024;
+
+struct Chunk {
+    uint64_t offset;
+    uint32_t compressed_size;
+    uint32_t raw_size;
+};
+
+inline void put_uint(std::string& out, const uint64_t value, const size_t nb_bytes) {
+    for (size_t i = 0; i < nb_bytes; ++i) {
+        out.push_back(char((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline uint64_t get_uint(const char* in, const size_t nb_bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < nb_bytes; ++i) {
+        value |= uint64_t(uint8_t(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+inline bool is_chunked(const char* buffer, const size_t size) {
+    return size >= header_size + trailer_size && get_uint(buffer, 4) == magic
+           && get_uint(buffer + size - 4, 4) == magic;
+}
+
+// the size of a stream, its position being restored; 0 if it can't be seeked
+inline uint64_t stream_size(std::istream& in) {
+    const auto start = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto end = in.tellg();
+    in.clear();
+    in.seekg(start);
+    return start < 0 || end < start ? 0 : uint64_t(end - start);
+}
+
+// same as above, for a stream positioned at the beginning of the file, that is left at this position
+inline bool is_chunked(std::istream& in) {
+    const uint64_t size = stream_size(in);
+    if (size < header_size + trailer_size) {
+        return false;
+    }
+    const auto start = in.tellg();
+    char first[4], last[4];
+    in.read(first, 4);
+    in.seekg(start + std::streamoff(size - 4));
+    in.read(last, 4);
+    const bool chunked = in && get_uint(first, 4) == magic && get_uint(last, 4) == magic;
+    in.clear();
+    in.seekg(start);
+    return chunked;
+}
+
+// the entries of the index, starting at index_offset in a file of the given size
+inline std::vector<Chunk> read_entries(const char* index,
+                                       const uint64_t index_offset,
+                                       const uint64_t nb_chunks,
+                                       const uint64_t size) {
+    if (index_offset < header_size || index_offset + nb_chunks * index_entry_size + trailer_size != size) {
+        throw LZ4Exception();
+    }
+    std::vector<Chunk> chunks;
+    chunks.reserve(nb_chunks);
+    for (const char* entry = index; entry != index + nb_chunks * index_entry_size; entry += index_entry_size) {
+        const Chunk chunk{get_uint(entry, 8), uint32_t(get_uint(entry + 8, 4)), uint32_t(get_uint(entry + 12, 4))};
+        if (chunk.offset < header_size || chunk.offset + chunk.compressed_size > index_offset) {
+            throw LZ4Exception();
+        }
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+inline std::vector<Chunk> read_index(const char* buffer, const size_t size) {
+    if (!is_chunked(buffer, size) || get_uint(buffer + 4, 4) != version) {
+        throw LZ4Exception();
+    }
+    const char* trailer = buffer + size - trailer_size;
+    const uint64_t index_offset = get_uint(trailer, 8);
+    return read_entries(buffer + std::min<uint64_t>(index_offset, size), index_offset, get_uint(trailer + 8, 4), size);
+}
+
+// only reads the header, the index and the trailer of the stream, that is left at the beginning of the file
+inline std::vector<Chunk> read_index(std::istream& in) {
+    if (!is_chunked(in)) {
+        throw LZ4Exception();
+    }
+    const uint64_t size = stream_size(in);
+    const auto start = in.tellg();
+    char header[header_size], trailer[trailer_size];
+    in.read(header, header_size);
+    in.seekg(start + std::streamoff(size - trailer_size));
+    in.read(trailer, trailer_size);
+    const uint64_t index_offset = get_uint(trailer, 8);
+    const uint64_t nb_chunks = get_uint(trailer + 8, 4);
+    if (!in || get_uint(header + 4, 4) != version
+        || index_offset + nb_chunks * index_entry_size + trailer_size != size) {
+        throw LZ4Exception();
+    }
+    std::string index(nb_chunks * index_entry_size, '\0');
+    in.seekg(start + std::streamoff(index_offset));
+    in.read(&index[0], index.size());
+    if (!in) {
+        throw LZ4Exception();
+    }
+    in.seekg(start);
+    return read_entries(index.data(), index_offset, nb_chunks, size);
+}
+
+inline std::string compress_chunk(const std::string& raw) {
+    std::string compressed(LZ4_compressBound(int(raw.size())), '\0');
+    const int size = LZ4_compress_default(raw.data(), &compressed[0], int(raw.size()), int(compressed.size()));
+    if (size <= 0) {
+        throw LZ4Exception();
+    }
+    compressed.resize(size);
+    return compressed;
+}
+
+inline std::string decompress_chunk(const char* buffer, const Chunk& chunk) {
+    std::string raw(chunk.raw_size, '\0');
+    const int size =
+        LZ4_decompress_safe(buffer + chunk.offset, &raw[0], int(chunk.compressed_size), int(chunk.raw_size));
+    if (size < 0 || uint32_t(size) != chunk.raw_size) {
+        throw LZ4Exception();
+    }
+    return raw;
+}
+
+}  // namespace lz4_chunked
+
+/**
+ * Compression filter writing the chunked LZ4 container, the chunks being compressed by batches of
+ * nb_threads chunks, in parallel on the nb_threads threads of the filter.
+ *
+ * The index is written when the filter is closed.
+ */
+class LZ4ParallelCompressor : public boost::iostreams::multichar_output_filter {
+    struct State {
+        size_t nb_threads;
+        size_t chunk_size;
+        std::string current;               // raw data of the chunk being filled
+        std::vector<std::string> pending;  // full raw chunks waiting to be compressed
+        std::vector<lz4_chunked::Chunk> chunks;
+        uint64_t offset = 0;
+        std::unique_ptr<navitia::WorkerPool> workers;
+    };
+    // the filter is copied when pushed in a chain, the copies share the chunks
+    std::shared_ptr<State> state;
+
+    template <typename Sink>
+    void write_out(Sink& dest, const std::string& data) {
+        boost::iostreams::write(dest, data.data(), data.size());
+        state->offset += data.size();
+    }
+
+    template <typename Sink>
+    void write_header(Sink& dest) {
+        std::string header;
+        lz4_chunked::put_uint(header, lz4_chunked::magic, 4);
+        lz4_chunked::put_uint(header, lz4_chunked::version, 4);
+        lz4_chunked::put_uint(header, state->chunk_size, 4);
+        write_out(dest, header);
+    }
+
+    // compresses the pending chunks on the workers and writes them in order
+    template <typename Sink>
+    void flush_pending(Sink& dest) {
+        auto& pending = state->pending;
+        std::vector<std::future<std::string>> futures;
+        for (const auto& raw : pending) {
+            futures.push_back(state->workers->push([&raw]() { return lz4_chunked::compress_chunk(raw); }));
+        }
+        // the tasks read the pending chunks, they must be over before anything is rethrown
+        for (const auto& future : futures) {
+            future.wait();
+        }
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const auto compressed = futures[i].get();
+            state->chunks.push_back({state->offset, uint32_t(compressed.size()), uint32_t(pending[i].size())});
+            write_out(dest, compressed);
+        }
+        pending.clear();
+    }
+
+public:
+    LZ4ParallelCompressor(size_t nb_threads = 1, size_t chunk_size = lz4_chunked::default_chunk_size)
+        : state(std::make_shared<State>()) {
+        state->nb_threads = std::max<size_t>(nb_threads, 1);
+        state->chunk_size = std::max<size_t>(chunk_size, 1);
+        state->workers = std::make_unique<navitia::WorkerPool>(state->nb_threads);
+    }
+
+    template <typename Sink>
+    std::streamsize write(Sink& dest, const char* src, std::streamsize size) {
+        if (state->offset == 0) {
+            write_header(dest);
+        }
+        std::streamsize written = 0;
+        while (written < size) {
+            const auto nb = std::min<size_t>(size - written, state->chunk_size - state->current.size());
+            state->current.append(src + written, nb);
+            written += nb;
+            if (state->current.size() == state->chunk_size) {
+                state->pending.push_back(std::move(state->current));
+                state->current = std::string();
+                if (state->pending.size() >= state->nb_threads) {
+                    flush_pending(dest);
+                }
+            }
+        }
+        return size;
+    }
+
+    template <typename Sink>
+    void close(Sink& dest) {
+        if (state->offset == 0) {
+            write_header(dest);
+        }
+        if (!state->current.empty()) {
+            state->pending.push_back(std::move(state->current));
+            state->current = std::string();
+        }
+        flush_pending(dest);
+
+        const uint64_t index_offset = state->offset;
+        std::string index;
+        for (const auto& chunk : state->chunks) {
+            lz4_chunked::put_uint(index, chunk.offset, 8);
+            lz4_chunked::put_uint(index, chunk.compressed_size, 4);
+            lz4_chunked::put_uint(index, chunk.raw_size, 4);
+        }
+        lz4_chunked::put_uint(index, index_offset, 8);
+        lz4_chunked::put_uint(index, state->chunks.size(), 4);
+        lz4_chunked::put_uint(index, lz4_chunked::magic, 4);
+        write_out(dest, index);
+
+        // the filter can be reused for another stream
+        state->chunks.clear();
+        state->offset = 0;
+    }
+};
+
+/**
+ * Source reading a chunked LZ4 container, either held in memory (typically a mapped file) or read
+ * from a seekable stream.
+ *
+ * The chunks are decompressed ahead of the reader by the nb_threads threads of the source, so that
+ * the decompression runs in parallel with the consumer of the stream (e.g. the archive being
+ * deserialized). When reading a stream, only the chunks being decompressed are held in memory.
+ */
+class LZ4ParallelSource {
+    struct State {
+        const char* buffer = nullptr;
+        std::istream* stream = nullptr;  // read instead of the buffer when set
+        std::streampos start;            // position of the beginning of the file in the stream
+        std::vector<lz4_chunked::Chunk> chunks;
+        size_t nb_threads;
+        size_t next_chunk = 0;  // next chunk to be decompressed
+        std::deque<std::future<std::string>> decompressing;
+        std::string current;  // decompressed chunk being read
+        size_t position = 0;  // position of the reader in current
+        // declared last: the pending decompressions are over before the other members are destroyed
+        std::unique_ptr<navitia::WorkerPool> workers;
+    };
+    // the source is copied when pushed in a chain, the copies share the chunks
+    std::shared_ptr<State> state;
+
+    void launch_decompression(const lz4_chunked::Chunk& chunk) {
+        auto& s = *state;
+        if (s.stream == nullptr) {
+            const char* buffer = s.buffer;
+            s.decompressing.push_back(
+                s.workers->push([buffer, chunk]() { return lz4_chunked::decompress_chunk(buffer, chunk); }));
+            return;
+        }
+        std::string compressed(chunk.compressed_size, '\0');
+        s.stream->seekg(s.start + std::streamoff(chunk.offset));
+        s.stream->read(&compressed[0], compressed.size());
+        if (!*s.stream) {
+            throw LZ4Exception();
+        }
+        const lz4_chunked::Chunk block{0, chunk.compressed_size, chunk.raw_size};
+        s.decompressing.push_back(s.workers->push([compressed = std::move(compressed), block]() {
+            return lz4_chunked::decompress_chunk(compressed.data(), block);
+        }));
+    }
+
+    void launch_decompressions() {
+        auto& s = *state;
+        while (s.decompressing.size() < 2 * s.nb_threads && s.next_chunk < s.chunks.size()) {
+            launch_decompression(s.chunks[s.next_chunk]);
+            ++s.next_chunk;
+        }
+    }
+
+    void start_workers(const size_t nb_threads) {
+        state->nb_threads = std::max<size_t>(nb_threads, 1);
+        state->workers = std::make_unique<navitia::WorkerPool>(state->nb_threads);
+    }
+
+public:
+    using char_type = char;
+    using category = boost::iostreams::source_tag;
+
+    LZ4ParallelSource(const char* buffer, size_t size, size_t nb_threads = 1) : state(std::make_shared<State>()) {
+        state->buffer = buffer;
+        state->chunks = lz4_chunked::read_index(buffer, size);
+        start_workers(nb_threads);
+    }
+
+    /// the stream is positioned at the beginning of the file and must outlive the source
+    LZ4ParallelSource(std::istream& stream, size_t nb_threads = 1) : state(std::make_shared<State>()) {
+        state->stream = &stream;
+        state->start = stream.tellg();
+        state->chunks = lz4_chunked::read_index(stream);
+        start_workers(nb_threads);
+    }
+
+    std::streamsize read(char* dest, std::streamsize size) {
+        auto& s = *state;
+        std::streamsize read_size = 0;
+        while (read_size < size) {
+            if (s.position == s.current.size()) {
+                launch_decompressions();
+                if (s.decompressing.empty()) {
+                    break;
+                }
+                s.current = s.decompressing.front().get();
+                s.decompressing.pop_front();
+                s.position = 0;
+                continue;
+            }
+            const auto nb = std::min<size_t>(size - read_size, s.current.size() - s.position);
+            std::memcpy(dest + read_size, s.current.data() + s.position, nb);
+            s.position += nb;
+            read_size += nb;
+        }
+        return read_size == 0 ? -1 : read_size;
+    }
+};
@@ -36,21 +36,33 @@ www.navitia.io
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/filesystem.hpp>
+#include <sstream>
 #include <string>
 
+// compressed file written in the temporary directory, removed at the end of the test
+struct TmpFile {
+    const std::string path =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("lz4_filter_%%%%-%%%%.lz4"))
+            .string();
+    ~TmpFile() { boost::filesystem::remove(path); }
+};
+
 BOOST_AUTO_TEST_CASE(tiny_string_compression) {
     std::string str = "foo";
     std::string result;
+    TmpFile file;
     {
         boost::iostreams::filtering_ostream out;
         out.push(LZ4Compressor());
-        out.push(boost::iostreams::file_sink("my_file.lz4"));
+        out.push(boost::iostreams::file_sink(file.path));
         out << str;
     }
     {
         boost::iostreams::filtering_istream in;
         in.push(LZ4Decompressor());
-        in.push(boost::iostreams::file_source("my_file.lz4"));
+        in.push(boost::iostreams::file_source(file.path));
         in >> result;
     }
     BOOST_CHECK_EQUAL(str, result);
@@ -60,16 +72,17 @@ BOOST_AUTO_TEST_CASE(string_compression) {
     std::string str =
         "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf_zéhefuçgzifgpzugfầi_zehufzeêfhzugfpeuzghfçpuzehfpuzghf";
     std::string result;
+    TmpFile file;
     {
         boost::iostreams::filtering_ostream out;
         out.push(LZ4Compressor());
-        out.push(boost::iostreams::file_sink("my_file.lz4"));
+        out.push(boost::iostreams::file_sink(file.path));
         out << str;
     }
     {
         boost::iostreams::filtering_istream in;
         in.push(LZ4Decompressor());
-        in.push(boost::iostreams::file_source("my_file.lz4"));
+        in.push(boost::iostreams::file_source(file.path));
         in >> result;
     }
     BOOST_CHECK_EQUAL(str, result);
@@ -81,17 +94,99 @@ BOOST_AUTO_TEST_CASE(big_string_compression) {
         str += str;
     }
     std::string result;
+    TmpFile file;
     {
         boost::iostreams::filtering_ostream out;
         out.push(LZ4Compressor());
-        out.push(boost::iostreams::file_sink("my_file.lz4"));
+        out.push(boost::iostreams::file_sink(file.path));
         out << str;
     }
     {
         boost::iostreams::filtering_istream in;
         in.push(LZ4Decompressor());
-        in.push(boost::iostreams::file_source("my_file.lz4"));
+        in.push(boost::iostreams::file_source(file.path));
         in >> result;
     }
     BOOST_CHECK_EQUAL(str, result);
 }
+
+static std::string chunked_compression(const std::string& str, const size_t nb_threads, const size_t chunk_size) {
+    std::string compressed;
+    {
+        boost::iostreams::filtering_ostream out;
+        out.push(LZ4ParallelCompressor(nb_threads, chunk_size));
+        out.push(boost::iostreams::back_inserter(compressed));
+        out << str;
+    }
+    return compressed;
+}
+
+static std::string chunked_decompression(const std::string& compressed, const size_t nb_threads) {
+    boost::iostreams::filtering_istream in;
+    in.push(LZ4ParallelSource(compressed.data(), compressed.size(), nb_threads));
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+BOOST_AUTO_TEST_CASE(chunked_compression_round_trip) {
+    std::string str = "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf";
+    for (int i = 0; i < 10; i++) {
+        str += str + std::to_string(i);
+    }
+    for (const size_t nb_threads : {1, 3}) {
+        const auto compressed = chunked_compression(str, nb_threads, 1000);
+        BOOST_REQUIRE(lz4_chunked::is_chunked(compressed.data(), compressed.size()));
+        const auto chunks = lz4_chunked::read_index(compressed.data(), compressed.size());
+        BOOST_CHECK_EQUAL(chunks.size(), (str.size() + 999) / 1000);
+        BOOST_CHECK_EQUAL(chunks.back().raw_size, str.size() % 1000);
+
+        for (const size_t nb_decompression_threads : {1, 4}) {
+            BOOST_CHECK(str == chunked_decompression(compressed, nb_decompression_threads));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chunked_decompression_from_a_stream) {
+    std::string str = "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf";
+    for (int i = 0; i < 10; i++) {
+        str += str + std::to_string(i);
+    }
+    const auto compressed = chunked_compression(str, 2, 1000);
+    for (const size_t nb_threads : {1, 4}) {
+        // the file doesn't start at the beginning of the stream
+        std::istringstream stream("prefix" + compressed);
+        stream.seekg(6);
+        BOOST_REQUIRE(lz4_chunked::is_chunked(stream));
+        BOOST_CHECK_EQUAL(stream.tellg(), 6);
+        BOOST_CHECK_EQUAL(lz4_chunked::read_index(stream).size(), (str.size() + 999) / 1000);
+
+        boost::iostreams::filtering_istream in;
+        in.push(LZ4ParallelSource(stream, nb_threads));
+        BOOST_CHECK(str == std::string(std::istreambuf_iterator<char>(in), {}));
+    }
+
+    std::istringstream truncated(compressed.substr(0, compressed.size() - 4));
+    BOOST_CHECK(!lz4_chunked::is_chunked(truncated));
+    BOOST_CHECK_THROW(LZ4ParallelSource(truncated, 2), LZ4Exception);
+}
+
+BOOST_AUTO_TEST_CASE(chunked_compression_empty_string) {
+    const auto compressed = chunked_compression("", 2, 1000);
+    BOOST_REQUIRE(lz4_chunked::is_chunked(compressed.data(), compressed.size()));
+    BOOST_CHECK(lz4_chunked::read_index(compressed.data(), compressed.size()).empty());
+    BOOST_CHECK(chunked_decompression(compressed, 2).empty());
+}
+
+BOOST_AUTO_TEST_CASE(chunked_and_legacy_formats_are_told_apart) {
+    std::string legacy;
+    {
+        boost::iostreams::filtering_ostream out;
+        out.push(LZ4Compressor());
+        out.push(boost::iostreams::back_inserter(legacy));
+        out << "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf";
+    }
+    BOOST_CHECK(!lz4_chunked::is_chunked(legacy.data(), legacy.size()));
+
+    auto truncated = chunked_compression("foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf", 1, 10);
+    truncated.erase(20, 4);
+    BOOST_CHECK_THROW(LZ4ParallelSource(truncated.data(), truncated.size()), LZ4Exception);
+}
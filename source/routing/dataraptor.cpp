@@ -32,6 +32,7 @@ www.navitia.io
 
 #include "routing.h"
 #include "routing/raptor_utils.h"
+#include "utils/logger.h"
 
 #include <boost/range/algorithm_ext.hpp>
 
@@ -76,6 +77,21 @@ void dataRAPTOR::JppsFromSp::filter_jpps(const boost::dynamic_bitset<>& valid_jp
     }
 }
 
+void dataRAPTOR::JppsFromSp::assign_filtered(const JppsFromSp& other, const boost::dynamic_bitset<>& valid_jpps) {
+    if (jpps_from_sp.size() != other.jpps_from_sp.size()) {
+        jpps_from_sp = other.jpps_from_sp;
+    }
+    for (const auto sp_jpps : other.jpps_from_sp) {
+        auto& jpps = jpps_from_sp[sp_jpps.first];
+        jpps.clear();
+        for (const auto& jpp : sp_jpps.second) {
+            if (valid_jpps[jpp.idx.val]) {
+                jpps.push_back(jpp);
+            }
+        }
+    }
+}
+
 void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
     jpps_from_jp.assign(jp_container.get_jps_values());
     for (const auto jp : jp_container.get_jps()) {
@@ -90,6 +106,52 @@ void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
     }
 }
 
+void dataRAPTOR::PropertyMasks::load(const type::PT_Data& data, const JourneyPatternContainer& jp_container) {
+    const size_t nb_properties = type::Properties().size();
+    sps.assign(nb_properties, boost::dynamic_bitset<>(data.stop_points.size()));
+    jpps.assign(nb_properties, boost::dynamic_bitset<>(jp_container.nb_jpps()));
+    for (const auto* sp : data.stop_points) {
+        const auto properties = sp->properties();
+        for (size_t property = 0; property < nb_properties; ++property) {
+            sps[property].set(sp->idx, properties[property]);
+        }
+    }
+    for (const auto jpp : jp_container.get_jpps()) {
+        for (size_t property = 0; property < nb_properties; ++property) {
+            jpps[property].set(jpp.first.val, sps[property][jpp.second.sp_idx.val]);
+        }
+    }
+}
+
+// jp_vp[day][jp_idx] is set if a vj of the jp circulates the given day
+static void set_jp_validity(std::vector<boost::dynamic_bitset<>>& jp_vp,
+                            const JpIdx& jp_idx,
+                            const JourneyPattern& jp,
+                            const type::RTLevel rt_level) {
+    for (int i = 0; i <= 365; ++i) {
+        jp.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
+            if (vj.validity_patterns[rt_level]->check2(i)) {
+                jp_vp[i].set(jp_idx.val);
+                return false;
+            }
+            return true;
+        });
+    }
+}
+
+template <typename VJ>
+static bool same_vjs(const std::vector<const VJ*>& vjs, const std::vector<const VJ*>& previous_vjs) {
+    if (vjs.size() != previous_vjs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < vjs.size(); ++i) {
+        if (vjs[i]->uri != previous_vjs[i]->uri) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void dataRAPTOR::load(const type::PT_Data& pt_data, size_t cache_size) {
     jp_container.load(pt_data);
     labels_const.init_inf(pt_data.stop_points);
@@ -98,6 +160,7 @@ void dataRAPTOR::load(const type::PT_Data& pt_data, size_t cache_size) {
     connections.load(pt_data);
     jpps_from_sp.load(pt_data, jp_container);
     jpps_from_jp.load(jp_container);
+    property_masks.load(pt_data, jp_container);
     next_stop_time_data.load(jp_container);
 
     for (auto level_cont : jp_validity_patterns) {
@@ -105,15 +168,7 @@ void dataRAPTOR::load(const type::PT_Data& pt_data, size_t cache_size) {
         auto& jp_vp = level_cont.second;
         jp_vp.assign(366, boost::dynamic_bitset<>(jp_container.nb_jps()));
         for (const auto jp : jp_container.get_jps()) {
-            for (int i = 0; i <= 365; ++i) {
-                jp.second.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
-                    if (vj.validity_patterns[rt_level]->check2(i)) {
-                        jp_vp[i].set(jp.first.val);
-                        return false;
-                    }
-                    return true;
-                });
-            }
+            set_jp_validity(jp_vp, jp.first, jp.second, rt_level);
         }
     }
 
@@ -124,11 +179,87 @@ void dataRAPTOR::load(const type::PT_Data& pt_data, size_t cache_size) {
         }
     }
 
+    reused_jps = ReusedJps();
+    cached_next_st_manager = std::make_unique<CachedNextStopTimeManager>(*this, cache_size);
+}
+
+void dataRAPTOR::load(const type::PT_Data& pt_data,
+                      const dataRAPTOR& previous,
+                      const std::set<type::idx_t>& modified_routes,
+                      size_t cache_size) {
+    jp_container.load(pt_data);
+
+    // the stop points and their connections are not modified by the realtime
+    labels_const = previous.labels_const;
+    labels_const_reverse = previous.labels_const_reverse;
+    connections = previous.connections;
+    min_connection_time = previous.min_connection_time;
+
+    jpps_from_sp.load(pt_data, jp_container);
+    jpps_from_jp.load(jp_container);
+    property_masks.load(pt_data, jp_container);
+
+    // The jps are built route by route, thus the jps of a route that has not been
+    // modified are the same, in the same order, as in the previous version
+    IdxMap<JourneyPattern, boost::optional<JpIdx>> previous_jps;
+    previous_jps.assign(jp_container.get_jps_values());
+    size_t nb_reused_jps = 0;
+    for (const auto previous_route_jps : previous.jp_container.get_jps_from_route()) {
+        if (modified_routes.count(previous_route_jps.first.val) != 0) {
+            continue;
+        }
+        const auto& route_jps = jp_container.get_jps_from_route()[previous_route_jps.first];
+        if (route_jps.size() != previous_route_jps.second.size()) {
+            continue;
+        }
+        for (size_t i = 0; i < route_jps.size(); ++i) {
+            const auto& jp = jp_container.get(route_jps[i]);
+            const auto& previous_jp = previous.jp_container.get(previous_route_jps.second[i]);
+            if (jp.jpps.size() == previous_jp.jpps.size() && same_vjs(jp.discrete_vjs, previous_jp.discrete_vjs)
+                && same_vjs(jp.freq_vjs, previous_jp.freq_vjs)) {
+                previous_jps[route_jps[i]] = previous_route_jps.second[i];
+                ++nb_reused_jps;
+            }
+        }
+    }
+    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("logger"),
+                    "dataRAPTOR: " << nb_reused_jps << " / " << jp_container.nb_jps() << " journey patterns reused");
+
+    next_stop_time_data.load(jp_container, previous.next_stop_time_data, previous.jp_container, previous_jps);
+
+    for (auto level_cont : jp_validity_patterns) {
+        const auto rt_level = level_cont.first;
+        auto& jp_vp = level_cont.second;
+        const auto& previous_jp_vp = previous.jp_validity_patterns[rt_level];
+        jp_vp.assign(366, boost::dynamic_bitset<>(jp_container.nb_jps()));
+        for (const auto jp : jp_container.get_jps()) {
+            const auto& previous_jp_idx = previous_jps[jp.first];
+            if (!previous_jp_idx) {
+                set_jp_validity(jp_vp, jp.first, jp.second, rt_level);
+                continue;
+            }
+            for (int i = 0; i <= 365; ++i) {
+                jp_vp[i][jp.first.val] = previous_jp_vp[i][previous_jp_idx->val];
+            }
+        }
+    }
+
+    reused_jps.from = &previous;
+    reused_jps.jps = std::move(previous_jps);
     cached_next_st_manager = std::make_unique<CachedNextStopTimeManager>(*this, cache_size);
 }
 
 void dataRAPTOR::warmup(const dataRAPTOR& other) {
-    this->cached_next_st_manager->warmup(*other.cached_next_st_manager);
+    if (reused_jps.from == &other) {
+        warmup_from = &other;
+    }
+    try {
+        this->cached_next_st_manager->warmup(*other.cached_next_st_manager);
+    } catch (...) {
+        warmup_from = nullptr;
+        throw;
+    }
+    warmup_from = nullptr;
 }
 
 }  // namespace routing
@@ -40,6 +40,8 @@ www.navitia.io
 #include <boost/foreach.hpp>
 #include <boost/dynamic_bitset.hpp>
 
+#include <set>
+
 namespace navitia {
 namespace routing {
 
@@ -73,6 +75,8 @@ struct dataRAPTOR {
         inline const std::vector<Jpp>& operator[](const SpIdx& sp) const { return jpps_from_sp[sp]; }
         void load(const type::PT_Data&, const JourneyPatternContainer&);
         void filter_jpps(const boost::dynamic_bitset<>& valid_jpps);
+        // set the jpps of `other` that are in valid_jpps, reusing the vectors already allocated
+        void assign_filtered(const JppsFromSp& other, const boost::dynamic_bitset<>& valid_jpps);
 
         inline IdxMap<type::StopPoint, std::vector<Jpp>>::const_iterator begin() const { return jpps_from_sp.begin(); }
         inline IdxMap<type::StopPoint, std::vector<Jpp>>::const_iterator end() const { return jpps_from_sp.end(); }
@@ -98,6 +102,15 @@ struct dataRAPTOR {
     };
     JppsFromJp jpps_from_jp;
 
+    // for each stop point property, the stop points (and their jpps) having it, to
+    // filter the accessibility of a request with a few bitset operations
+    struct PropertyMasks {
+        std::vector<boost::dynamic_bitset<>> sps;   // sps[property][sp_idx]
+        std::vector<boost::dynamic_bitset<>> jpps;  // jpps[property][jpp_idx]
+        void load(const type::PT_Data&, const JourneyPatternContainer&);
+    };
+    PropertyMasks property_masks;
+
     NextStopTimeData next_stop_time_data;
     std::unique_ptr<CachedNextStopTimeManager> cached_next_st_manager;
 
@@ -113,7 +126,34 @@ struct dataRAPTOR {
     dataRAPTOR() = default;
     void load(const navitia::type::PT_Data&, size_t cache_size = 10);
 
+    /** Build dataRAPTOR from the one of the previous version of pt_data, after a realtime update.
+     *
+     *  The stop points must be the same in both versions. The validity and the next stop times of
+     *  the journey patterns of the routes that are not in modified_routes are taken from `previous`,
+     *  only the journey patterns of the modified routes are computed.
+     */
+    void load(const navitia::type::PT_Data&,
+              const dataRAPTOR& previous,
+              const std::set<type::idx_t>& modified_routes,
+              size_t cache_size = 10);
+
+    /** Warm the next stop time caches up with the days and parameters cached by `other`.
+     *
+     *  If this dataRAPTOR has been loaded from `other` after a realtime update, the cached stop
+     *  times of the reused journey patterns are copied from the caches of `other`, only the ones
+     *  of the modified journey patterns are computed.
+     */
     void warmup(const dataRAPTOR& other);
+
+    // The journey patterns taken from a previous dataRAPTOR by the realtime load
+    struct ReusedJps {
+        const dataRAPTOR* from = nullptr;  // only compared to the dataRAPTOR given to warmup, never dereferenced
+        IdxMap<JourneyPattern, boost::optional<JpIdx>> jps;  // for each jp, the jp of `from` it is the same as
+    };
+    ReusedJps reused_jps;
+
+    // During warmup, the dataRAPTOR whose caches are copied for the reused journey patterns
+    const dataRAPTOR* warmup_from = nullptr;
 };
 
 }  // namespace routing
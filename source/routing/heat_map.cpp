@@ -35,6 +35,8 @@ www.navitia.io
 #include "raptor_api.h"
 #include "type/geographical_coord.h"
 
+#include <exception>
+#include <future>
 #include <vector>
 
 namespace navitia {
@@ -132,13 +134,61 @@ static Boundary find_boundary(const std::pair<int, int>& rank_source,
     return {end_lon_box, end_lat_box, begin_lon_box, begin_lat_box};
 }
 
+// An edge of the walking graph, with the cells of the grid that can be projected on it
+struct ProjectableEdge {
+    georef::vertex_t source;
+    georef::vertex_t target;
+    type::GeographicalCoord source_coord;
+    type::GeographicalCoord target_coord;
+    Boundary boundary;
+};
+
+// The columns (lon ranks) of the grid are cut in tiles, run by the calling thread and by the threads of the pool: the
+// worker i handles the tiles i, i + nb_workers... A tile is only written by one thread, so no lock is needed as long
+// as f only touches the columns it is given.
+template <typename F>
+static void for_each_tile(const size_t step, WorkerPool* pool, const F& f) {
+    const size_t nb_threads = pool != nullptr ? pool->size() + 1 : 1;
+    // a few tiles by thread to even out the load between the dense and the empty parts of the grid
+    const size_t nb_tiles = std::min(step, nb_threads * 4);
+    const size_t nb_workers = std::min(nb_threads, nb_tiles);
+    const auto compute_tiles = [&](const size_t worker_idx) {
+        for (size_t tile = worker_idx; tile < nb_tiles; tile += nb_workers) {
+            f(tile * step / nb_tiles, (tile + 1) * step / nb_tiles);
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (size_t worker_idx = 1; worker_idx < nb_workers; ++worker_idx) {
+        futures.push_back(pool->push([&compute_tiles, worker_idx]() { compute_tiles(worker_idx); }));
+    }
+    // the tasks of the pool reference compute_tiles, they must all be finished before anything is rethrown
+    std::exception_ptr error;
+    try {
+        compute_tiles(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : futures) {
+        future.wait();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    for (auto& future : futures) {
+        // rethrows the exceptions of the threads
+        future.get();
+    }
+}
+
 static std::vector<std::vector<Projection>> find_projection(BoundBox box,
                                                             const double height_step,
                                                             const double width_step,
                                                             const georef::GeoRef& worker,
                                                             const double min_dist,
                                                             const HeatMap& heat_map,
-                                                            const size_t step) {
+                                                            const size_t step,
+                                                            WorkerPool* pool) {
     std::vector<std::vector<Projection>> dist_pixel = {step, {step, Projection()}};
     const size_t offset_lon = floor(min_dist / (width_step * N_DEG_TO_DISTANCE)) + 1;
     const size_t offset_lat = floor(min_dist / (height_step * N_DEG_TO_DISTANCE)) + 1;
@@ -150,10 +200,12 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
     auto objects_inside = worker.pl_walking.find_within(box_center, radius);
 
     if (objects_inside.empty()) {
-        return {};
+        return dist_pixel;
     }
 
-    const auto coslat = cos(objects_inside.front().second.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+    // the edges are gathered once, in the order of the sequential algorithm, so that each cell keeps
+    // the same projection whatever the number of threads
+    std::vector<ProjectableEdge> edges;
     for (const auto& o : objects_inside) {
         const auto element = o.first;
         const auto& source = o.second;
@@ -166,40 +218,49 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
             const auto v = target(e, worker.graph);
             const auto& target = worker.graph[v].coord;
             const auto rank_target = find_rank(box, target, height_step, width_step);
-            const auto boundary = find_boundary(rank_source, rank_target, offset_lon, offset_lat, step);
-            for (uint lon_rank = boundary.min_lon; lon_rank <= boundary.max_lon; lon_rank++) {
-                for (uint lat_rank = boundary.min_lat; lat_rank <= boundary.max_lat; lat_rank++) {
+            edges.push_back({element, v, source, target,
+                             find_boundary(rank_source, rank_target, offset_lon, offset_lat, step)});
+        }
+    }
+
+    const auto coslat = cos(objects_inside.front().second.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+    for_each_tile(step, pool, [&](const size_t tile_begin, const size_t tile_end) {
+        for (const auto& edge : edges) {
+            const auto& boundary = edge.boundary;
+            const size_t min_lon = std::max(boundary.min_lon, tile_begin);
+            const size_t max_lon = std::min(boundary.max_lon + 1, tile_end);
+            for (size_t lon_rank = min_lon; lon_rank < max_lon; lon_rank++) {
+                auto& column = dist_pixel[lon_rank];
+                for (size_t lat_rank = boundary.min_lat; lat_rank <= boundary.max_lat; lat_rank++) {
                     auto center = type::GeographicalCoord(heat_map.body[lon_rank].first.min_coord + width_step / 2,
                                                           heat_map.header[lat_rank].min_coord + height_step / 2);
-                    auto proj = center.approx_project(source, target, coslat);
+                    auto proj = center.approx_project(edge.source_coord, edge.target_coord, coslat);
                     auto length = double(proj.second);
-                    if (length < min_dist
-                        && (!dist_pixel[lon_rank][lat_rank].distance
-                            || length < *dist_pixel[lon_rank][lat_rank].distance)) {
-                        dist_pixel[lon_rank][lat_rank].distance = length;
-                        dist_pixel[lon_rank][lat_rank].source = element;
-                        dist_pixel[lon_rank][lat_rank].target = v;
+                    if (length < min_dist && (!column[lat_rank].distance || length < *column[lat_rank].distance)) {
+                        column[lat_rank].distance = length;
+                        column[lat_rank].source = edge.source;
+                        column[lat_rank].target = edge.target;
                     }
                 }
             }
         }
-    }
+    });
     return dist_pixel;
 }
 
-HeatMap fill_heat_map(const BoundBox& box,
-                      const double height_step,
-                      const double width_step,
-                      const georef::GeoRef& worker,
-                      const double min_dist,
-                      const double max_duration,
-                      const double speed,
-                      const std::vector<navitia::time_duration>& distances,
-                      const size_t step) {
-    auto heat_map = HeatMap(step, box, height_step, width_step);
-    auto projection = find_projection(box, height_step, width_step, worker, min_dist, heat_map, step);
-    for (size_t i = 0; i < step; i++) {
-        for (size_t j = 0; j < step; j++) {
+// Sets the duration of the cells of the columns [lon_begin, lon_end) from their projection on the walking graph
+static void fill_durations(HeatMap& heat_map,
+                           const std::vector<std::vector<Projection>>& projection,
+                           const size_t lon_begin,
+                           const size_t lon_end,
+                           const double height_step,
+                           const double width_step,
+                           const georef::GeoRef& worker,
+                           const double max_duration,
+                           const double speed,
+                           const std::vector<navitia::time_duration>& distances) {
+    for (size_t i = lon_begin; i < lon_end; i++) {
+        for (size_t j = 0; j < heat_map.header.size(); j++) {
             auto& duration = heat_map.body[i].second[j];
             if (projection[i][j].distance) {
                 auto center = type::GeographicalCoord(heat_map.body[i].first.min_coord + width_step / 2,
@@ -224,6 +285,24 @@ HeatMap fill_heat_map(const BoundBox& box,
             }
         }
     }
+}
+
+HeatMap fill_heat_map(const BoundBox& box,
+                      const double height_step,
+                      const double width_step,
+                      const georef::GeoRef& worker,
+                      const double min_dist,
+                      const double max_duration,
+                      const double speed,
+                      const std::vector<navitia::time_duration>& distances,
+                      const size_t step,
+                      WorkerPool* pool) {
+    auto heat_map = HeatMap(step, box, height_step, width_step);
+    auto projection = find_projection(box, height_step, width_step, worker, min_dist, heat_map, step, pool);
+    for_each_tile(step, pool, [&](const size_t tile_begin, const size_t tile_end) {
+        fill_durations(heat_map, projection, tile_begin, tile_end, height_step, width_step, worker, max_duration,
+                       speed, distances);
+    });
     return heat_map;
 }
 
@@ -232,13 +311,14 @@ static std::string build_grid(const georef::GeoRef& worker,
                               const std::vector<navitia::time_duration>& distances,
                               const double speed,
                               const double max_duration,
-                              const uint resolution) {
+                              const uint resolution,
+                              WorkerPool* pool) {
     double width_step = (box.max.lon() - box.min.lon()) / resolution;
     double height_step = (box.max.lat() - box.min.lat()) / resolution;
     auto min_dist = std::max(500., width_step * N_DEG_TO_DISTANCE);
     min_dist = std::max(min_dist, height_step * N_DEG_TO_DISTANCE);
-    auto heat_map =
-        fill_heat_map(box, height_step, width_step, worker, min_dist, max_duration, speed, distances, resolution);
+    auto heat_map = fill_heat_map(box, height_step, width_step, worker, min_dist, max_duration, speed, distances,
+                                  resolution, pool);
     return print_grid(heat_map);
 }
 
@@ -351,7 +431,8 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
                                    const DateTime duration,
                                    const bool clockwise,
                                    const DateTime bound,
-                                   const uint resolution) {
+                                   const uint resolution,
+                                   WorkerPool* pool) {
     const auto& stop_points = raptor.data.pt_data->stop_points;
     std::vector<georef::vertex_t> predecessors;
     size_t n = boost::num_vertices(worker.graph);
@@ -365,15 +446,16 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
     float speed_factor = float(speed) / georef::default_speed[mode];
     auto visitor = georef::dijkstra_distance_visitor(navitia::seconds(duration), distances);
     auto index_map = boost::identity_property_map();
-    using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, georef::TransportationModeFilter>;
     try {
-        boost::dijkstra_shortest_paths_no_init(
-            filtered_graph(worker.graph, {}, georef::TransportationModeFilter(mode, worker)), start, end,
-            &predecessors[0], &distances[0], boost::get(&georef::Edge::duration, worker.graph), index_map,
-            std::less<>(), georef::SpeedDistanceCombiner(speed_factor), navitia::seconds(0), visitor);
+        georef::visit_mode_graph(worker, mode, [&](const auto& g, const auto& weight_map) {
+            boost::dijkstra_shortest_paths_no_init(g, start, end, &predecessors[0], &distances[0], weight_map,
+                                                   index_map, std::less<>(),
+                                                   georef::SpeedDistanceCombiner(speed_factor), navitia::seconds(0),
+                                                   visitor);
+        });
     } catch (georef::DestinationFound) {
     }
-    return build_grid(worker, box, distances, speed, duration, resolution);
+    return build_grid(worker, box, distances, speed, duration, resolution, pool);
 }
 
 }  // namespace routing
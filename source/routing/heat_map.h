@@ -110,6 +110,7 @@ std::vector<navitia::time_duration> init_distance(const georef::GeoRef& worker,
                                                   const DateTime& bound,
                                                   const double speed);
 
+/// the tiles of the grid are rasterized by the calling thread and by the threads of pool, if any
 HeatMap fill_heat_map(const BoundBox& box,
                       const double height_step,
                       const double width_step,
@@ -118,7 +119,8 @@ HeatMap fill_heat_map(const BoundBox& box,
                       const double max_duration,
                       const double speed,
                       const std::vector<navitia::time_duration>& distances,
-                      const size_t step);
+                      const size_t step,
+                      WorkerPool* pool = nullptr);
 
 std::string print_grid(const HeatMap& heat_map);
 
@@ -131,7 +133,8 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
                                    const DateTime duration,
                                    const bool clockwise,
                                    const DateTime bound,
-                                   const uint resolution);
+                                   const uint resolution,
+                                   WorkerPool* pool = nullptr);
 
 }  // namespace routing
 }  // namespace navitia
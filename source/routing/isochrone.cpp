@@ -139,14 +139,16 @@ type::Polygon circle(const type::GeographicalCoord& center, const double& radius
     return points;
 }
 
-static type::MultiPolygon merge_poly(const type::MultiPolygon& multi_poly, const type::Polygon& poly) {
+static type::MultiPolygon merge_poly(const type::MultiPolygon& lhs, const type::MultiPolygon& rhs) {
     type::MultiPolygon poly_union;
     try {
-        boost::geometry::union_(poly, multi_poly, poly_union);
+        boost::geometry::union_(lhs, rhs, poly_union);
     } catch (const boost::geometry::exception& e) {
         // We don't merge the polygons
         log4cplus::Logger logger = log4cplus::Logger::getInstance("logger");
         LOG4CPLUS_WARN(logger, "impossible to merge polygon: " << e.what());
+        poly_union = lhs;
+        poly_union.insert(poly_union.end(), rhs.begin(), rhs.end());
     }
     return poly_union;
 }
@@ -186,47 +188,128 @@ DateTime build_bound(const bool clockwise, const DateTime duration, const DateTi
     return clockwise ? init_dt + duration : init_dt - duration;
 }
 
-type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
-                                          const std::vector<type::StopPoint*>& stop_points,
-                                          const bool clockwise,
-                                          const type::GeographicalCoord& coord_origin,
-                                          const DateTime& bound,
-                                          const map_stop_point_duration& origin,
-                                          const double& speed,
-                                          const int& duration) {
-    std::vector<InfoCircle> circles_classed;
-    type::MultiPolygon circles;
-    circles_classed.emplace_back(coord_origin, duration);
+// Index of the point on a z-order curve of 2^16 x 2^16 cells
+static uint32_t z_order(const uint32_t x, const uint32_t y) {
+    uint32_t key = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        key |= ((x >> i) & 1u) << (2 * i);
+        key |= ((y >> i) & 1u) << (2 * i + 1);
+    }
+    return key;
+}
+
+/*
+ * Cascaded union of the circles: the circles are sorted along a z-order curve, then merged two by two,
+ * level after level, like a balanced binary tree.
+ * Each union only involves neighbouring shapes of similar size, instead of merging every circle with the
+ * (growing) union of all the previous ones.
+ */
+static type::MultiPolygon union_circles(const std::vector<InfoCircle>& circles, const double speed) {
+    if (circles.empty()) {
+        return {};
+    }
+    auto min_lon = circles.front().center.lon();
+    auto max_lon = min_lon;
+    auto min_lat = circles.front().center.lat();
+    auto max_lat = min_lat;
+    for (const auto& c : circles) {
+        min_lon = std::min(min_lon, c.center.lon());
+        max_lon = std::max(max_lon, c.center.lon());
+        min_lat = std::min(min_lat, c.center.lat());
+        max_lat = std::max(max_lat, c.center.lat());
+    }
+    const auto cell = [](const double coord, const double min, const double max) {
+        return max > min ? uint32_t((coord - min) / (max - min) * 0xffff) : 0u;
+    };
+    std::vector<std::pair<uint32_t, const InfoCircle*>> sorted_circles;
+    sorted_circles.reserve(circles.size());
+    for (const auto& c : circles) {
+        sorted_circles.emplace_back(
+            z_order(cell(c.center.lon(), min_lon, max_lon), cell(c.center.lat(), min_lat, max_lat)), &c);
+    }
+    std::stable_sort(sorted_circles.begin(), sorted_circles.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<type::MultiPolygon> shapes;
+    shapes.reserve(sorted_circles.size());
+    for (const auto& c : sorted_circles) {
+        shapes.push_back({circle(c.second->center, c.second->duration_left * speed)});
+    }
+    while (shapes.size() > 1) {
+        std::vector<type::MultiPolygon> merged_shapes;
+        merged_shapes.reserve((shapes.size() + 1) / 2);
+        for (size_t i = 0; i + 1 < shapes.size(); i += 2) {
+            merged_shapes.push_back(merge_poly(shapes[i], shapes[i + 1]));
+        }
+        if (shapes.size() % 2 == 1) {
+            merged_shapes.push_back(std::move(shapes.back()));
+        }
+        shapes = std::move(merged_shapes);
+    }
+    return std::move(shapes.front());
+}
+
+// A point reached by public transport, or an origin stop point, with the duration needed to reach it
+struct ReachedPoint {
+    type::GeographicalCoord center;
+    int duration;
+    ReachedPoint(const type::GeographicalCoord& center, const int duration) : center(center), duration(duration) {}
+};
+
+static std::vector<ReachedPoint> find_reached_points(const RAPTOR& raptor,
+                                                     const std::vector<type::StopPoint*>& stop_points,
+                                                     const bool clockwise,
+                                                     const DateTime& bound,
+                                                     const map_stop_point_duration& origin,
+                                                     const int duration) {
+    std::vector<ReachedPoint> reached_points;
     const auto& data_departure = raptor.data.pt_data->stop_points;
     for (const auto& it : origin) {
         if (it.second.total_seconds() < duration) {
-            int duration_left = duration - int(it.second.total_seconds());
-            if (duration_left * speed < MIN_RADIUS) {
-                continue;
-            }
-            const auto& center = data_departure[it.first.val]->coord;
-            circles_classed.emplace_back(center, duration_left);
+            reached_points.emplace_back(data_departure[it.first.val]->coord, int(it.second.total_seconds()));
         }
     }
     for (const type::StopPoint* sp : stop_points) {
         SpIdx sp_idx(*sp);
         const auto best_lbl = raptor.best_labels[sp_idx].dt_pt;
         if (in_bound(best_lbl, bound, clockwise)) {
-            uint duration_left = abs(int(best_lbl) - int(bound));
-            if (duration_left * speed < MIN_RADIUS) {
-                continue;
-            }
-            const auto& center = sp->coord;
-            circles_classed.emplace_back(center, duration_left);
+            reached_points.emplace_back(sp->coord, duration - abs(int(best_lbl) - int(bound)));
         }
     }
-    std::vector<InfoCircle> circles_check = delete_useless_circle(std::move(circles_classed), speed);
+    return reached_points;
+}
 
-    for (const auto& c : circles_check) {
-        type::Polygon circle_to_add = circle(c.center, c.duration_left * speed);
-        circles = merge_poly(circles, circle_to_add);
+// Shape of the isochrone of the given duration, the points being reached within a duration at least as long
+static type::MultiPolygon build_isochrone_shape(const std::vector<ReachedPoint>& reached_points,
+                                                const type::GeographicalCoord& coord_origin,
+                                                const double speed,
+                                                const int duration) {
+    std::vector<InfoCircle> circles_classed;
+    circles_classed.emplace_back(coord_origin, duration);
+    for (const auto& point : reached_points) {
+        if (point.duration >= duration) {
+            continue;
+        }
+        const int duration_left = duration - point.duration;
+        if (duration_left * speed < MIN_RADIUS) {
+            continue;
+        }
+        circles_classed.emplace_back(point.center, duration_left);
     }
-    return circles;
+    std::vector<InfoCircle> circles_check = delete_useless_circle(std::move(circles_classed), speed);
+    return union_circles(circles_check, speed);
+}
+
+type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
+                                          const std::vector<type::StopPoint*>& stop_points,
+                                          const bool clockwise,
+                                          const type::GeographicalCoord& coord_origin,
+                                          const DateTime& bound,
+                                          const map_stop_point_duration& origin,
+                                          const double& speed,
+                                          const int& duration) {
+    const auto reached_points = find_reached_points(raptor, stop_points, clockwise, bound, origin, duration);
+    return build_isochrone_shape(reached_points, coord_origin, speed, duration);
 }
 
 std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
@@ -238,15 +321,17 @@ std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
                                         const DateTime init_dt) {
     std::vector<Isochrone> isochrone;
     if (!boundary_duration.empty()) {
-        type::MultiPolygon max_isochrone = build_single_isochrone(
-            raptor, raptor.data.pt_data->stop_points, clockwise, coord_origin,
-            build_bound(clockwise, boundary_duration[0], init_dt), origin, speed, boundary_duration[0]);
+        // the points reached within the first (and longest) duration are gathered once for all the boundaries
+        const auto reached_points =
+            find_reached_points(raptor, raptor.data.pt_data->stop_points, clockwise,
+                                build_bound(clockwise, boundary_duration[0], init_dt), origin, boundary_duration[0]);
+        type::MultiPolygon max_isochrone =
+            build_isochrone_shape(reached_points, coord_origin, speed, boundary_duration[0]);
         for (size_t i = 1; i < boundary_duration.size(); i++) {
             type::MultiPolygon output;
             if (boundary_duration[i] > 0) {
-                type::MultiPolygon min_isochrone = build_single_isochrone(
-                    raptor, raptor.data.pt_data->stop_points, clockwise, coord_origin,
-                    build_bound(clockwise, boundary_duration[i], init_dt), origin, speed, boundary_duration[i]);
+                type::MultiPolygon min_isochrone =
+                    build_isochrone_shape(reached_points, coord_origin, speed, boundary_duration[i]);
                 boost::geometry::difference(max_isochrone, min_isochrone, output);
                 max_isochrone = std::move(min_isochrone);
             } else {
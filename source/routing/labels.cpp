@@ -29,7 +29,8 @@ www.navitia.io
 */
 
 #include "routing/labels.h"
-#include "utils/boost_patched/range/combine.hpp"
+
+#include <utility>
 
 namespace navitia {
 namespace routing {
@@ -37,32 +38,11 @@ namespace routing {
 Labels::Labels() = default;
 Labels::Labels(const std::vector<type::StopPoint*> stop_points) : labels(stop_points) {}
 
-Labels::Labels(const Map& dt_pts, const Map& dt_transfers, const Map& walkings, const Map& walking_transfers) {
-    const auto& zip = boost::combine(dt_pts, dt_transfers.values(), walkings.values(), walking_transfers.values());
-    labels.resize(zip.size());
-    for (const auto& z : zip) {
-        const auto sp_idx = z.get<0>().first;
-        labels[sp_idx] = Label{z.get<0>().second, z.get<1>(), z.get<2>(), z.get<3>()};
-    }
-}
-
-std::array<Labels::Map, 4> Labels::inrow_labels() {
-    std::array<Map, 4> row_labels;
-
-    for (auto& row_label : row_labels)
-        row_label.resize(labels.size());
-
-    for (const auto& l : labels) {
-        const auto& sp_idx = l.first;
-        const auto& label = l.second;
-
-        row_labels[0][sp_idx] = label.dt_pt;
-        row_labels[1][sp_idx] = label.dt_transfer;
-        row_labels[2][sp_idx] = label.walking_duration_pt;
-        row_labels[3][sp_idx] = label.walking_duration_transfer;
+void Labels::swap_pt_and_transfer() {
+    for (auto& label : labels.values()) {
+        std::swap(label.dt_pt, label.dt_transfer);
+        std::swap(label.walking_duration_pt, label.walking_duration_transfer);
     }
-
-    return row_labels;
 }
 
 void Labels::fill_values(DateTime pts, DateTime transfert, DateTime walking, DateTime walking_transfert) {
@@ -64,12 +64,10 @@ struct Label {
 };
 
 struct Labels {
-    using Map = IdxMap<type::StopPoint, DateTime>;
     using LabelsMap = IdxMap<type::StopPoint, Label>;
 
     Labels();
     Labels(const std::vector<type::StopPoint*> stop_points);
-    Labels(const Map& dt_pts, const Map& dt_transfers, const Map& walkings, const Map& walking_transfers);
 
     // initialize the structure according to the number of jpp
     void init_inf(const std::vector<type::StopPoint*>& stops) { init(stops, DateTimeUtils::inf); }
@@ -80,13 +78,8 @@ struct Labels {
 
     LabelsMap::range values() { return labels.values(); }
 
-    /* Split each label's field in a specific vector, and return them individually in an array of :
-     *  1. stop point arrival datetime
-     *  2. stop point transfer datime
-     *  3. stop point waling duration
-     *  4. stop point walking transfer duration
-     */
-    std::array<Labels::Map, 4> inrow_labels();
+    // swap the pt and transfer fields of every label, as needed by a raptor going the other way in time
+    void swap_pt_and_transfer();
 
     void fill_values(DateTime pts, DateTime transfert, DateTime walking, DateTime walking_transfert);
 
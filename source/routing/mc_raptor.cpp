@@ -0,0 +1,464 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/mc_raptor.h"
+
+#include "routing/raptor.h"
+#include "type/pt_data.h"
+#include "type/stop_point.h"
+#include "type/stop_time.h"
+#include "type/vehicle_journey.h"
+
+#include <boost/range/algorithm/reverse.hpp>
+#include <boost/range/algorithm/sort.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace navitia {
+namespace routing {
+
+constexpr size_t McRaptorParams::max_criteria;
+constexpr uint32_t McRaptor::no_parent;
+
+uint32_t FareZoneCrossings::ride_cost(const type::StopTime& from, const type::StopTime& to) const {
+    return from.stop_point->fare_zone != to.stop_point->fare_zone ? 1 : 0;
+}
+
+uint32_t MissingVehicleProperties::boarding_cost(const type::StopTime& st) const {
+    return st.vehicle_journey->accessible(wanted) ? 0 : 1;
+}
+
+std::shared_ptr<const McCriterion> make_mc_criterion(const std::string& name) {
+    if (name == "fare_zone_crossings") {
+        return std::make_shared<const FareZoneCrossings>();
+    }
+    type::VehicleProperties wanted;
+    if (name == "wheelchair_accessible") {
+        wanted.set(type::hasVehicleProperties::WHEELCHAIR_ACCESSIBLE);
+    } else if (name == "bike_accepted") {
+        wanted.set(type::hasVehicleProperties::BIKE_ACCEPTED);
+    } else if (name == "air_conditioned") {
+        wanted.set(type::hasVehicleProperties::AIR_CONDITIONED);
+    } else if (name == "visual_announcement") {
+        wanted.set(type::hasVehicleProperties::VISUAL_ANNOUNCEMENT);
+    } else if (name == "audible_announcement") {
+        wanted.set(type::hasVehicleProperties::AUDIBLE_ANNOUNCEMENT);
+    } else {
+        throw std::invalid_argument("unknown mc raptor criterion: " + name);
+    }
+    return std::make_shared<const MissingVehicleProperties>(name, wanted);
+}
+
+McRaptor::McRaptor(const RAPTOR& raptor, const McRaptorParams& params)
+    : raptor(raptor), params(params), nb_criteria(params.criteria.size()) {
+    if (nb_criteria > McRaptorParams::max_criteria) {
+        throw std::invalid_argument("too many mc raptor criteria: " + std::to_string(nb_criteria));
+    }
+}
+
+bool McRaptor::dominates(const Label& lhs, const Label& rhs) const {
+    if (lhs.dt > rhs.dt || lhs.walking > rhs.walking) {
+        return false;
+    }
+    for (size_t i = 0; i < nb_criteria; ++i) {
+        if (lhs.costs[i] > rhs.costs[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// As Dominates, the arrival and the walking of each target are penalized by its number of transfers
+bool McRaptor::dominates(const Target& lhs, const Target& rhs) const {
+    if (lhs.round > rhs.round) {
+        return false;
+    }
+    if (lhs.arrival + arrival_transfer_penalty * lhs.round > rhs.arrival + arrival_transfer_penalty * rhs.round) {
+        return false;
+    }
+    if (lhs.walking + walking_transfer_penalty * lhs.round > rhs.walking + walking_transfer_penalty * rhs.round) {
+        return false;
+    }
+    for (size_t i = 0; i < nb_criteria; ++i) {
+        if (lhs.costs[i] > rhs.costs[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the targets are kept Pareto optimal, among equivalent ones the first one is kept
+void McRaptor::add_target(const Target& target) {
+    for (const auto& t : targets) {
+        if (dominates(t, target)) {
+            return;
+        }
+    }
+    targets.erase(std::remove_if(targets.begin(), targets.end(), [&](const Target& t) { return dominates(target, t); }),
+                  targets.end());
+    targets.push_back(target);
+}
+
+// As TargetPruning: a label of the given round can only lead to journeys arriving not before
+// dt + min_fallback, with at least that round, walking + min_fallback of walking and its costs,
+// and their penalties grow with the round.
+bool McRaptor::dominated_by_targets(const Label& label, const uint32_t round) const {
+    const DateTime min_arrival = label.dt + min_fallback + arrival_transfer_penalty * round;
+    const DateTime min_walking = label.walking + min_fallback + walking_transfer_penalty * round;
+    for (const auto& target : targets) {
+        if (target.round > round || target.arrival + arrival_transfer_penalty * target.round >= min_arrival
+            || target.walking + walking_transfer_penalty * target.round > min_walking) {
+            continue;
+        }
+        size_t i = 0;
+        while (i < nb_criteria && target.costs[i] <= label.costs[i]) {
+            ++i;
+        }
+        if (i == nb_criteria) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool McRaptor::insert(Bag& bag, const uint32_t label_idx) {
+    const Label& label = pool[label_idx];
+    for (const auto idx : bag) {
+        if (dominates(pool[idx], label)) {
+            return false;
+        }
+    }
+    bag.erase(std::remove_if(bag.begin(), bag.end(), [&](uint32_t idx) { return dominates(label, pool[idx]); }),
+              bag.end());
+    if (bag.size() < params.max_bag_size) {
+        bag.push_back(label_idx);
+        return true;
+    }
+    // the bag is full, the earliest arrivals are kept
+    auto latest = std::max_element(bag.begin(), bag.end(),
+                                   [&](uint32_t lhs, uint32_t rhs) { return pool[lhs].dt < pool[rhs].dt; });
+    if (pool[*latest].dt <= label.dt) {
+        return false;
+    }
+    *latest = label_idx;
+    return true;
+}
+
+uint32_t McRaptor::add_label(const Label& label, Bag& round_bag, Bag& best_bag, const uint32_t round) {
+    if (label.dt > bound || dominated_by_targets(label, round)) {
+        return no_parent;
+    }
+    for (const auto idx : best_bag) {
+        if (dominates(pool[idx], label)) {
+            return no_parent;
+        }
+    }
+    const auto label_idx = static_cast<uint32_t>(pool.size());
+    pool.push_back(label);
+    if (!insert(round_bag, label_idx)) {
+        pool.pop_back();
+        return no_parent;
+    }
+    insert(best_bag, label_idx);
+    return label_idx;
+}
+
+void McRaptor::mark_journey_patterns(const SpIdx sp_idx) {
+    for (const auto& jpp : raptor.jpps_from_sp[sp_idx]) {
+        int& order = marked_orders[jpp.jp_idx.val];
+        if (order == std::numeric_limits<int>::max()) {
+            marked_jps.push_back(jpp.jp_idx);
+        }
+        order = std::min<int>(order, jpp.order);
+    }
+}
+
+void McRaptor::add_transfer_label(const Label& label, const uint32_t round) {
+    const auto sp = label.sp_idx.val;
+    if (!raptor.valid_stop_points[sp]) {
+        return;
+    }
+    const bool first_of_round = transfer_bags[sp].empty();
+    if (add_label(label, transfer_bags[sp], best_transfer_bags[sp], round) != no_parent && first_of_round) {
+        touched_transfer.push_back(label.sp_idx);
+        mark_journey_patterns(label.sp_idx);
+    }
+}
+
+void McRaptor::add_route_label(const RouteLabel& route_label) {
+    for (auto& other : route_bag) {
+        // only the labels of the same trip are comparable, as the vehicle journeys may overtake each other
+        if (other.st != route_label.st || other.base_dt != route_label.base_dt) {
+            continue;
+        }
+        size_t i = 0;
+        while (i < nb_criteria && other.costs[i] <= route_label.costs[i]) {
+            ++i;
+        }
+        if (i == nb_criteria && other.walking <= route_label.walking) {
+            return;
+        }
+    }
+    if (route_bag.size() < params.max_bag_size) {
+        route_bag.push_back(route_label);
+        return;
+    }
+    const auto departure = [](const RouteLabel& l) { return l.st->departure(l.base_dt); };
+    auto latest = std::max_element(route_bag.begin(), route_bag.end(),
+                                   [&](const RouteLabel& lhs, const RouteLabel& rhs) {
+                                       return departure(lhs) < departure(rhs);
+                                   });
+    if (departure(route_label) < departure(*latest)) {
+        *latest = route_label;
+    }
+}
+
+void McRaptor::scan_journey_pattern(const JpIdx jp_idx,
+                                    const uint16_t first_order,
+                                    const uint32_t round,
+                                    const type::RTLevel rt_level,
+                                    const type::VehicleProperties& vehicle_properties) {
+    const auto& jpps = raptor.data.dataRaptor->jpps_from_jp[jp_idx];
+    route_bag.clear();
+    for (auto it = jpps.begin() + first_order; it != jpps.end(); ++it) {
+        const auto& jpp = *it;
+        const auto sp = jpp.sp_idx.val;
+        const bool valid_sp = raptor.valid_stop_points[sp];
+
+        // we first get off the boarded vehicles, then try to board from the labels of the previous round
+        for (auto& route_label : route_bag) {
+            const type::StopTime* previous_st = route_label.st;
+            ++route_label.st;
+            for (size_t i = 0; i < nb_criteria; ++i) {
+                route_label.costs[i] += params.criteria[i]->ride_cost(*previous_st, *route_label.st);
+            }
+            const type::StopTime& st = *route_label.st;
+            const auto l_zone = route_label.board_st->local_traffic_zone;
+            if (!valid_sp || !st.valid_end(true)
+                || (l_zone != std::numeric_limits<uint16_t>::max() && l_zone == st.local_traffic_zone)) {
+                continue;
+            }
+            const Label label{st.section_end(route_label.base_dt, true),
+                              route_label.walking,
+                              route_label.costs,
+                              route_label.parent,
+                              jpp.sp_idx,
+                              route_label.board_st,
+                              route_label.board_dt,
+                              &st};
+            const bool first_of_round = pt_bags[sp].empty();
+            const auto label_idx = add_label(label, pt_bags[sp], best_pt_bags[sp], round);
+            if (label_idx == no_parent) {
+                continue;
+            }
+            if (first_of_round) {
+                touched_pt.push_back(jpp.sp_idx);
+            }
+            const auto fallback = destination_fallback[sp];
+            if (fallback != DateTimeUtils::not_valid) {
+                add_target({label.dt + fallback, label.walking + fallback, label.costs, round, label_idx});
+            }
+        }
+
+        if (!valid_sp) {
+            continue;
+        }
+        for (const auto label_idx : prev_transfer_bags[sp]) {
+            const Label& from = pool[label_idx];
+            const auto st_dt = raptor.next_st->next_stop_time(StopEvent::pick_up, jpp.idx, from.dt, true, rt_level,
+                                                              vehicle_properties, jpp.has_freq);
+            if (st_dt.first == nullptr) {
+                continue;
+            }
+            RouteLabel route_label{st_dt.first,  st_dt.first->base_dt(st_dt.second, true),
+                                   from.walking, from.costs,
+                                   label_idx,    st_dt.first,
+                                   st_dt.second};
+            for (size_t i = 0; i < nb_criteria; ++i) {
+                route_label.costs[i] += params.criteria[i]->boarding_cost(*st_dt.first);
+            }
+            add_route_label(route_label);
+        }
+    }
+}
+
+void McRaptor::foot_paths(const uint32_t round) {
+    const auto& connections = raptor.data.dataRaptor->connections.forward_connections;
+    for (const auto sp_idx : touched_pt) {
+        for (const auto label_idx : pt_bags[sp_idx.val]) {
+            for (const auto& conn : connections[sp_idx]) {
+                Label label = pool[label_idx];
+                label.dt += conn.duration;
+                label.walking += conn.walking_duration;
+                label.parent = label_idx;
+                label.sp_idx = conn.sp_idx;
+                label.board_st = nullptr;
+                label.alight_st = nullptr;
+                add_transfer_label(label, round);
+            }
+        }
+    }
+}
+
+bool McRaptor::budget_reached() {
+    if (!out_of_budget && params.time_budget.count() > 0) {
+        out_of_budget = std::chrono::steady_clock::now() - start > params.time_budget;
+    }
+    return out_of_budget;
+}
+
+Journey McRaptor::make_journey(const Label& arrival, const DateTime fallback) const {
+    Journey j;
+    DateTime departure_walking = 0;
+    for (const Label* label = &arrival; label != nullptr;) {
+        j.sections.emplace_back(*label->board_st, label->board_dt, *label->alight_st, label->dt);
+        const Label& boarded_from = pool[label->parent];
+        if (boarded_from.parent == no_parent) {
+            departure_walking = boarded_from.walking;
+            label = nullptr;
+        } else {
+            label = &pool[boarded_from.parent];
+        }
+    }
+    boost::reverse(j.sections);
+
+    j.departure_dt = j.sections.front().get_in_dt - departure_walking;
+    j.arrival_dt = arrival.dt + fallback;
+    j.sn_dur = navitia::seconds(departure_walking + fallback);
+    for (size_t i = 1; i < j.sections.size(); ++i) {
+        const auto& from = j.sections[i - 1];
+        const auto& to = j.sections[i];
+        const auto* conn =
+            raptor.data.pt_data->get_stop_point_connection(*from.get_out_st->stop_point, *to.get_in_st->stop_point);
+        const auto dur_conn = navitia::seconds(conn ? conn->display_duration : 0);
+        const auto waiting = navitia::seconds(to.get_in_dt - from.get_out_dt) - dur_conn;
+        j.transfer_dur += dur_conn;
+        j.min_waiting_dur = i == 1 ? waiting : std::min(j.min_waiting_dur, waiting);
+        j.total_waiting_dur += waiting;
+    }
+    return j;
+}
+
+McRaptor::Journeys McRaptor::compute(const map_stop_point_duration& departures,
+                                     const map_stop_point_duration& destinations,
+                                     const DateTime departure_datetime,
+                                     const DateTime bound,
+                                     const type::RTLevel rt_level,
+                                     const navitia::time_duration& arrival_transfer_penalty,
+                                     const navitia::time_duration& walking_transfer_penalty,
+                                     const uint32_t max_transfers,
+                                     const type::VehicleProperties& vehicle_properties,
+                                     const boost::optional<navitia::time_duration>& direct_path_dur) {
+    start = std::chrono::steady_clock::now();
+    out_of_budget = false;
+    this->bound = bound;
+    this->arrival_transfer_penalty = arrival_transfer_penalty.total_seconds();
+    this->walking_transfer_penalty = walking_transfer_penalty.total_seconds();
+
+    const size_t nb_sps = raptor.data.pt_data->stop_points.size();
+    pool.clear();
+    targets.clear();
+    for (auto* bags : {&pt_bags, &transfer_bags, &prev_transfer_bags, &best_pt_bags, &best_transfer_bags}) {
+        bags->assign(nb_sps, Bag());
+    }
+    touched_pt.clear();
+    touched_transfer.clear();
+    prev_touched_transfer.clear();
+    marked_orders.assign(raptor.data.dataRaptor->jp_container.nb_jps(), std::numeric_limits<int>::max());
+    marked_jps.clear();
+
+    destination_fallback.assign(nb_sps, DateTimeUtils::not_valid);
+    min_fallback = destinations.empty() ? 0 : DateTimeUtils::inf;
+    for (const auto& sp_dur : destinations) {
+        destination_fallback[sp_dur.first.val] = sp_dur.second.total_seconds();
+        min_fallback = std::min<DateTime>(min_fallback, sp_dur.second.total_seconds());
+    }
+    if (direct_path_dur) {
+        const DateTime dur = direct_path_dur->total_seconds();
+        add_target({departure_datetime + dur, dur, Costs{}, 0, no_parent});
+    }
+
+    for (const auto& sp_dur : departures) {
+        const DateTime walking = sp_dur.second.total_seconds();
+        const Label label{departure_datetime + walking, walking, Costs{}, no_parent, sp_dur.first, nullptr, 0, nullptr};
+        add_transfer_label(label, 0);
+    }
+
+    for (uint32_t round = 1; round <= max_transfers + 1 && !marked_jps.empty() && !out_of_budget; ++round) {
+        // the transfer labels of the previous round are the ones to board from
+        std::swap(transfer_bags, prev_transfer_bags);
+        std::swap(touched_transfer, prev_touched_transfer);
+        for (const auto sp_idx : touched_transfer) {
+            transfer_bags[sp_idx.val].clear();
+        }
+        touched_transfer.clear();
+        for (const auto sp_idx : touched_pt) {
+            pt_bags[sp_idx.val].clear();
+        }
+        touched_pt.clear();
+
+        auto jps = std::move(marked_jps);
+        marked_jps.clear();
+        boost::sort(jps);
+        for (const auto jp_idx : jps) {
+            const auto first_order = static_cast<uint16_t>(marked_orders[jp_idx.val]);
+            marked_orders[jp_idx.val] = std::numeric_limits<int>::max();
+            scan_journey_pattern(jp_idx, first_order, round, rt_level, vehicle_properties);
+            if (budget_reached()) {
+                break;
+            }
+        }
+        foot_paths(round);
+    }
+    if (out_of_budget) {
+        LOG4CPLUS_WARN(raptor.raptor_logger, "McRaptor: time budget reached, " << targets.size() << " arrivals found");
+    }
+
+    // the targets are already Pareto optimal
+    Journeys journeys;
+    for (const auto& target : targets) {
+        if (target.label_idx == no_parent) {
+            // the direct path, as the solutions of RAPTOR::compute_all_journeys
+            Journey j;
+            j.sn_dur = navitia::seconds(target.walking);
+            j.departure_dt = departure_datetime;
+            j.arrival_dt = target.arrival;
+            journeys.push_back(j);
+            continue;
+        }
+        const auto& label = pool[target.label_idx];
+        journeys.push_back(make_journey(label, target.arrival - label.dt));
+    }
+    return journeys;
+}
+
+}  // namespace routing
+}  // namespace navitia
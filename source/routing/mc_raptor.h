@@ -0,0 +1,221 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "routing/journey.h"
+#include "routing/raptor_utils.h"
+#include "type/rt_level.h"
+#include "type/type_interfaces.h"
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <chrono>
+#include <limits>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace navitia {
+
+namespace type {
+struct StopTime;
+}
+
+namespace routing {
+
+struct RAPTOR;
+
+/** A pluggable criterion of the multi-criteria raptor.
+ *
+ *  A criterion is an additive cost, the lower the better, accumulated when boarding a vehicle
+ *  journey and when riding it from one stop time to the next one. The arrival datetime, the
+ *  walking duration and the number of transfers are always optimized.
+ */
+struct McCriterion {
+    virtual ~McCriterion() = default;
+    virtual std::string name() const = 0;
+    /// cost of boarding the vehicle journey of st at st
+    virtual uint32_t boarding_cost(const type::StopTime& /*st*/) const { return 0; }
+    /// cost of riding from `from` to the next stop time `to` of the same vehicle journey
+    virtual uint32_t ride_cost(const type::StopTime& /*from*/, const type::StopTime& /*to*/) const { return 0; }
+};
+
+/// number of fare zone changes along the ridden stop points
+struct FareZoneCrossings : McCriterion {
+    std::string name() const override { return "fare_zone_crossings"; }
+    uint32_t ride_cost(const type::StopTime& from, const type::StopTime& to) const override;
+};
+
+/// number of boarded vehicle journeys not having all the wanted vehicle properties (comfort)
+struct MissingVehicleProperties : McCriterion {
+    explicit MissingVehicleProperties(std::string name, const type::VehicleProperties& wanted)
+        : criterion_name(std::move(name)), wanted(wanted) {}
+    std::string name() const override { return criterion_name; }
+    uint32_t boarding_cost(const type::StopTime& st) const override;
+
+private:
+    std::string criterion_name;
+    type::VehicleProperties wanted;
+};
+
+/// Build a criterion from its name: "fare_zone_crossings", "air_conditioned", "bike_accepted",
+/// "wheelchair_accessible"... Throws std::invalid_argument on an unknown name
+std::shared_ptr<const McCriterion> make_mc_criterion(const std::string& name);
+
+struct McRaptorParams {
+    static constexpr size_t max_criteria = 4;
+
+    std::vector<std::shared_ptr<const McCriterion>> criteria;
+    /// maximum number of labels of a bag; when full, a new label only replaces the latest one if it arrives earlier
+    size_t max_bag_size = 16;
+    /// the rounds stop once this duration is elapsed, and the journeys found so far are returned (0: no limit)
+    std::chrono::milliseconds time_budget{0};
+};
+
+/** Multi-criteria raptor (McRAPTOR), clockwise only.
+ *
+ *  Instead of one label per stop point and round, each stop point holds a bag of Pareto optimal
+ *  labels on (arrival, walking, criteria costs), the number of transfers being given by the round.
+ *  The bags are propagated through the rounds as the labels of RAPTOR are, and the journeys are
+ *  read directly from the labels reaching the destinations, without any second pass.
+ *
+ *  As in RAPTOR, a journey with more transfers is only kept if it arrives earlier, or walks less,
+ *  by at least the arrival (resp. walking) transfer penalty per extra transfer.
+ *
+ *  The valid journey patterns, stop points and next stop times of the given RAPTOR are used,
+ *  set_valid_jp_and_jpp and the next stop time must thus have been set before.
+ */
+class McRaptor {
+public:
+    using Costs = std::array<uint32_t, McRaptorParams::max_criteria>;
+    using Journeys = std::list<Journey>;
+
+    McRaptor(const RAPTOR& raptor, const McRaptorParams& params);
+
+    Journeys compute(const map_stop_point_duration& departures,
+                     const map_stop_point_duration& destinations,
+                     const DateTime departure_datetime,
+                     const DateTime bound,
+                     const type::RTLevel rt_level,
+                     const navitia::time_duration& arrival_transfer_penalty,
+                     const navitia::time_duration& walking_transfer_penalty,
+                     const uint32_t max_transfers,
+                     const type::VehicleProperties& vehicle_properties,
+                     const boost::optional<navitia::time_duration>& direct_path_dur = boost::none);
+
+    /// true if the last compute has been stopped by the time budget
+    bool budget_exceeded() const { return out_of_budget; }
+
+private:
+    static constexpr uint32_t no_parent = std::numeric_limits<uint32_t>::max();
+
+    struct Label {
+        DateTime dt;
+        DateTime walking;
+        Costs costs;
+        uint32_t parent;  // for a pt label, the transfer label boarded from, for a transfer one, the pt label
+        SpIdx sp_idx;
+        // set on pt labels only
+        const type::StopTime* board_st;
+        DateTime board_dt;
+        const type::StopTime* alight_st;
+    };
+    using Bag = std::vector<uint32_t>;  // index of the labels in `pool`
+
+    // a vehicle journey boarded from a transfer label, during the scan of a journey pattern
+    struct RouteLabel {
+        const type::StopTime* st;  // stop time of the stop point being scanned
+        DateTime base_dt;
+        DateTime walking;
+        Costs costs;
+        uint32_t parent;
+        const type::StopTime* board_st;
+        DateTime board_dt;
+    };
+
+    // labels reaching the destinations (with their fallback) and their round
+    struct Target {
+        DateTime arrival;
+        DateTime walking;
+        Costs costs;
+        uint32_t round;
+        uint32_t label_idx;
+    };
+
+    bool dominates(const Label& lhs, const Label& rhs) const;
+    bool dominates(const Target& lhs, const Target& rhs) const;
+    void add_target(const Target& target);
+    bool dominated_by_targets(const Label& label, const uint32_t round) const;
+    bool insert(Bag& bag, const uint32_t label_idx);
+    uint32_t add_label(const Label& label, Bag& round_bag, Bag& best_bag, const uint32_t round);
+    void add_transfer_label(const Label& label, const uint32_t round);
+    void add_route_label(const RouteLabel& route_label);
+    void mark_journey_patterns(const SpIdx sp_idx);
+    void scan_journey_pattern(const JpIdx jp_idx,
+                              const uint16_t first_order,
+                              const uint32_t round,
+                              const type::RTLevel rt_level,
+                              const type::VehicleProperties& vehicle_properties);
+    void foot_paths(const uint32_t round);
+    bool budget_reached();
+    Journey make_journey(const Label& label, const DateTime fallback) const;
+
+    const RAPTOR& raptor;
+    DateTime bound = DateTimeUtils::inf;
+    const McRaptorParams& params;
+    size_t nb_criteria;
+
+    std::vector<Label> pool;
+    // bags of the current round, by stop point, for the labels arriving by a vehicle (pt) and after a
+    // connection or at the departure (transfer), and of all the rounds for the local pruning
+    std::vector<Bag> pt_bags, transfer_bags, prev_transfer_bags;
+    std::vector<Bag> best_pt_bags, best_transfer_bags;
+    std::vector<SpIdx> touched_pt, touched_transfer, prev_touched_transfer;
+    // first order to scan of each journey pattern marked for the next round
+    std::vector<int> marked_orders;
+    std::vector<JpIdx> marked_jps;
+    std::vector<RouteLabel> route_bag;
+
+    // Pareto front of the labels reaching the destinations
+    std::vector<Target> targets;
+    std::vector<DateTime> destination_fallback;
+    DateTime min_fallback = 0;
+    DateTime arrival_transfer_penalty = 0;
+    DateTime walking_transfer_penalty = 0;
+
+    std::chrono::steady_clock::time_point start;
+    bool out_of_budget = false;
+};
+
+}  // namespace routing
+}  // namespace navitia
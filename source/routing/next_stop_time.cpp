@@ -60,7 +60,22 @@ bool NextStopTimeData::Arrival::is_valid(const type::StopTime& st) const {
 }
 
 template <typename Getter>
-void NextStopTimeData::TimesStopTimes<Getter>::init(const JourneyPattern& jp, const JourneyPatternPoint& jpp) {
+void NextStopTimeData::TimesStopTimes<Getter>::assign(const JourneyPatternContainer& jp_container) {
+    size_t nb_stop_times = 0;
+    for (const auto& jp : jp_container.get_jps_values()) {
+        nb_stop_times += jp.discrete_vjs.size() * jp.jpps.size();
+    }
+    times.clear();
+    stop_times.clear();
+    times.reserve(nb_stop_times);
+    stop_times.reserve(nb_stop_times);
+    ranges.assign(jp_container.get_jpps_values());
+}
+
+template <typename Getter>
+void NextStopTimeData::TimesStopTimes<Getter>::add(const JppIdx jpp_idx,
+                                                   const JourneyPattern& jp,
+                                                   const JourneyPatternPoint& jpp) {
     using StopTimePair = std::pair<const type::StopTime*, const type::StopTime*>;
     // collect the stop times at the given jpp
     const auto jpp_order = jpp.order;
@@ -93,27 +108,76 @@ void NextStopTimeData::TimesStopTimes<Getter>::init(const JourneyPattern& jp, co
         }
         return st1_first->vehicle_journey->idx < st2_first->vehicle_journey->idx;
     });
-    stop_times.reserve(jp.discrete_vjs.size());
+
+    // collect the stop times and their corresponding times
+    auto& range = ranges[jpp_idx];
+    range.first = stop_times.size();
     for (const auto& pair : stop_times_and_earliest_stop_time) {
         stop_times.push_back(pair.first);
+        times.push_back(DateTimeUtils::hour(getter.get_time(*pair.first)));
     }
+    range.last = stop_times.size();
+}
 
-    // collect the corresponding times
-    times.reserve(stop_times.size());
-    for (const auto* st : stop_times) {
-        times.push_back(DateTimeUtils::hour(getter.get_time(*st)));
+template <typename Getter>
+void NextStopTimeData::TimesStopTimes<Getter>::add_from(const JppIdx jpp_idx,
+                                                        const TimesStopTimes& previous,
+                                                        const JppIdx previous_jpp_idx,
+                                                        const VjMap& new_vjs) {
+    // the vjs are the same, so are their stop times and their order
+    const auto& previous_range = previous.ranges[previous_jpp_idx];
+    auto& range = ranges[jpp_idx];
+    range.first = stop_times.size();
+    for (auto i = previous_range.first; i < previous_range.last; ++i) {
+        const auto* st = previous.stop_times[i];
+        const auto* vj = new_vjs.at(st->vehicle_journey);
+        stop_times.push_back(&vj->stop_time_list[st->order().val]);
+        times.push_back(previous.times[i]);
+    }
+    range.last = stop_times.size();
+}
+
+void NextStopTimeData::load(const JourneyPatternContainer& jp_container,
+                            const NextStopTimeData& previous,
+                            const JourneyPatternContainer& previous_jp_container,
+                            const IdxMap<JourneyPattern, boost::optional<JpIdx>>& previous_jps) {
+    departure.assign(jp_container);
+    arrival.assign(jp_container);
+
+    VjMap new_vjs;
+    for (const auto jp : jp_container.get_jps()) {
+        const auto& previous_jp_idx = previous_jps[jp.first];
+        if (!previous_jp_idx) {
+            for (const auto& jpp_idx : jp.second.jpps) {
+                const auto& jpp = jp_container.get(jpp_idx);
+                departure.add(jpp_idx, jp.second, jpp);
+                arrival.add(jpp_idx, jp.second, jpp);
+            }
+            continue;
+        }
+        const auto& previous_jp = previous_jp_container.get(*previous_jp_idx);
+        new_vjs.clear();
+        for (size_t i = 0; i < jp.second.discrete_vjs.size(); ++i) {
+            new_vjs[previous_jp.discrete_vjs[i]] = jp.second.discrete_vjs[i];
+        }
+        for (size_t i = 0; i < jp.second.jpps.size(); ++i) {
+            const auto& jpp_idx = jp.second.jpps[i];
+            const auto& previous_jpp_idx = previous_jp.jpps[i];
+            departure.add_from(jpp_idx, previous.departure, previous_jpp_idx, new_vjs);
+            arrival.add_from(jpp_idx, previous.arrival, previous_jpp_idx, new_vjs);
+        }
     }
 }
 
 void NextStopTimeData::load(const JourneyPatternContainer& jp_container) {
-    departure.assign(jp_container.get_jpps_values());
-    arrival.assign(jp_container.get_jpps_values());
+    departure.assign(jp_container);
+    arrival.assign(jp_container);
 
     for (const auto jp : jp_container.get_jps()) {
         for (const auto& jpp_idx : jp.second.jpps) {
             const auto& jpp = jp_container.get(jpp_idx);
-            departure[jpp_idx].init(jp.second, jpp);
-            arrival[jpp_idx].init(jp.second, jpp);
+            departure.add(jpp_idx, jp.second, jpp);
+            arrival.add(jpp_idx, jp.second, jpp);
         }
     }
 }
@@ -430,6 +494,34 @@ bool CachedNextStopTimeKey::operator<(const CachedNextStopTimeKey& other) const
     return accessibilite_params < other.accessibilite_params;
 }
 
+// Copies the cached stop times of the jpps of previous_jp to the ones of jp, both having the same vjs in the same order
+static void copy_cache(const JourneyPattern& jp,
+                       const JourneyPattern& previous_jp,
+                       const CachedNextStopTime& previous_cache,
+                       std::unordered_map<const type::VehicleJourney*, const type::VehicleJourney*>& new_vjs,
+                       CachedNextStopTime::vDtStByJpp& arrival_cache,
+                       CachedNextStopTime::vDtStByJpp& departure_cache) {
+    new_vjs.clear();
+    for (size_t i = 0; i < jp.discrete_vjs.size(); ++i) {
+        new_vjs[previous_jp.discrete_vjs[i]] = jp.discrete_vjs[i];
+    }
+    for (size_t i = 0; i < jp.freq_vjs.size(); ++i) {
+        new_vjs[previous_jp.freq_vjs[i]] = jp.freq_vjs[i];
+    }
+    const auto copy = [&](const boost::iterator_range<CachedNextStopTime::vDtSt::const_iterator>& previous_dtsts,
+                          CachedNextStopTime::vDtSt& dtsts) {
+        dtsts.reserve(previous_dtsts.size());
+        for (const auto& dtst : previous_dtsts) {
+            const auto* vj = new_vjs.at(dtst.second->vehicle_journey);
+            dtsts.emplace_back(dtst.first, &vj->stop_time_list[dtst.second->order().val]);
+        }
+    };
+    for (size_t i = 0; i < jp.jpps.size(); ++i) {
+        copy(previous_cache.arrivals(previous_jp.jpps[i]), arrival_cache[jp.jpps[i]]);
+        copy(previous_cache.departures(previous_jp.jpps[i]), departure_cache[jp.jpps[i]]);
+    }
+}
+
 CachedNextStopTime CachedNextStopTimeManager::CacheCreator::operator()(const CachedNextStopTimeKey& key) const {
     CachedNextStopTime::vDtStByJpp departure, arrival;
     const auto& jp_container = dataRaptor.jp_container;
@@ -439,18 +531,36 @@ CachedNextStopTime CachedNextStopTimeManager::CacheCreator::operator()(const Cac
     DateTime dt_from = DateTimeUtils::set(key.from, 0);
     DateTime dt_to = DateTimeUtils::set(key.from + 2, 0);  // cache window is 2-days wide (journeys : 24h max)
 
-    for (const auto& jp : jp_container.get_jps_values()) {
-        fill_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp, jp.discrete_vjs, arrival, departure);
-        fill_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp, jp.freq_vjs, arrival, departure);
+    // during the warmup following a realtime load, the cache of the reused jps is taken from the previous data
+    const auto* previous = dataRaptor.warmup_from;
+    const CachedNextStopTime* previous_cache = nullptr;
+    if (previous != nullptr) {
+        const auto it = previous_caches->find(key);
+        if (it != previous_caches->end()) {
+            previous_cache = it->second.get();
+        }
     }
+    std::unordered_map<const type::VehicleJourney*, const type::VehicleJourney*> new_vjs;
+
     auto compare = [](const CachedNextStopTime::DtSt& lhs, const CachedNextStopTime::DtSt& rhs) noexcept {
         return lhs.first < rhs.first;
     };
-    for (const auto jpp_dtst : arrival) {
-        boost::sort(jpp_dtst.second, compare);
-    }
-    for (const auto jpp_dtst : departure) {
-        boost::sort(jpp_dtst.second, compare);
+    for (const auto jp : jp_container.get_jps()) {
+        const auto& previous_jp_idx = previous_cache != nullptr ? dataRaptor.reused_jps.jps[jp.first] : boost::none;
+        if (previous_jp_idx) {
+            // the previous cache is already sorted
+            copy_cache(jp.second, previous->jp_container.get(*previous_jp_idx), *previous_cache, new_vjs, arrival,
+                       departure);
+            continue;
+        }
+        fill_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp.second, jp.second.discrete_vjs, arrival,
+                   departure);
+        fill_cache(dt_from, dt_to, key.rt_level, key.accessibilite_params, jp.second, jp.second.freq_vjs, arrival,
+                   departure);
+        for (const auto& jpp_idx : jp.second.jpps) {
+            boost::sort(arrival[jpp_idx], compare);
+            boost::sort(departure[jpp_idx], compare);
+        }
     }
     return {departure, arrival};
 }
@@ -515,8 +625,52 @@ std::shared_ptr<const CachedNextStopTime> CachedNextStopTimeManager::load(
     const DateTime from,
     const type::RTLevel rt_level,
     const type::AccessibiliteParams& accessibilite_params) {
-    CachedNextStopTimeKey key(DateTimeUtils::date(from), rt_level, accessibilite_params);
-    return lru(key);
+    return load(CachedNextStopTimeKey(DateTimeUtils::date(from), rt_level, accessibilite_params));
+}
+
+std::shared_ptr<const CachedNextStopTime> CachedNextStopTimeManager::load(const CachedNextStopTimeKey& key) {
+    auto cache = lru(key);
+    std::lock_guard<std::mutex> lock(*loaded_mutex);
+    ++nb_loads;
+    auto it = loaded.find(key);
+    if (it == loaded.end()) {
+        // the released caches are forgotten when a new key comes
+        for (auto expired = loaded.begin(); expired != loaded.end();) {
+            expired = expired->second.cache.expired() ? loaded.erase(expired) : std::next(expired);
+        }
+        loaded.emplace(key, LoadedCache{cache, nb_loads});
+    } else {
+        if (it->second.cache.expired()) {
+            it->second.cache = cache;
+        }
+        it->second.last_use = nb_loads;
+    }
+    return cache;
+}
+
+void CachedNextStopTimeManager::warmup(const CachedNextStopTimeManager& other) {
+    std::vector<std::pair<size_t, CachedNextStopTimeKey>> keys_by_last_use;
+    {
+        std::lock_guard<std::mutex> lock(*other.loaded_mutex);
+        for (const auto& key_cache : other.loaded) {
+            if (auto cache = key_cache.second.cache.lock()) {
+                previous_caches->emplace(key_cache.first, std::move(cache));
+                keys_by_last_use.emplace_back(key_cache.second.last_use, key_cache.first);
+            }
+        }
+    }
+    // the most recently used keys are loaded last, so that they are the ones kept by the lru
+    boost::sort(keys_by_last_use, [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    const auto nb_kept = std::min(keys_by_last_use.size(), lru.get_max_size());
+    try {
+        for (auto it = keys_by_last_use.end() - nb_kept; it != keys_by_last_use.end(); ++it) {
+            load(it->second);
+        }
+    } catch (...) {
+        previous_caches->clear();
+        throw;
+    }
+    previous_caches->clear();
 }
 
 inline static bool within(u_int32_t val, std::pair<u_int32_t, u_int32_t> bound) {
@@ -45,6 +45,12 @@ www.navitia.io
 #include <boost/optional.hpp>
 #include <boost/dynamic_bitset.hpp>
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace navitia {
 
 namespace type {
@@ -79,20 +85,27 @@ struct NextStopTimeData {
 
     void load(const JourneyPatternContainer&);
 
+    /// Same as load, but the stop times of the jps that have a value in previous_jps are not sorted,
+    /// they are taken from the corresponding jp of previous (loaded on the previous version of the data)
+    void load(const JourneyPatternContainer&,
+              const NextStopTimeData& previous,
+              const JourneyPatternContainer& previous_jp_container,
+              const IdxMap<JourneyPattern, boost::optional<JpIdx>>& previous_jps);
+
     // Returns the range of the stop times in increasing time order
     inline StopTimeIter stop_time_range_forward(const JppIdx jpp_idx, const StopEvent stop_event) const {
         if (stop_event == StopEvent::pick_up) {
-            return departure[jpp_idx].stop_time_range();
+            return departure.stop_time_range(jpp_idx);
         } else {
-            return arrival[jpp_idx].stop_time_range();
+            return arrival.stop_time_range(jpp_idx);
         }
     }
     // Returns the range of the stop times in decreasing time order
     inline StopTimeReverseIter stop_time_range_backward(const JppIdx jpp_idx, const StopEvent stop_event) const {
         if (stop_event == StopEvent::pick_up) {
-            return departure[jpp_idx].reverse_stop_time_range();
+            return departure.reverse_stop_time_range(jpp_idx);
         } else {
-            return arrival[jpp_idx].reverse_stop_time_range();
+            return arrival.reverse_stop_time_range(jpp_idx);
         }
     }
     // Returns the range of the stop times in increasing time order beginning after hour(dt)
@@ -100,9 +113,9 @@ struct NextStopTimeData {
                                               const DateTime dt,
                                               const StopEvent stop_event) const {
         if (stop_event == StopEvent::pick_up) {
-            return departure[jpp_idx].next_stop_time_range(dt);
+            return departure.next_stop_time_range(jpp_idx, dt);
         } else {
-            return arrival[jpp_idx].next_stop_time_range(dt);
+            return arrival.next_stop_time_range(jpp_idx, dt);
         }
     }
     // Returns the range of the stop times in decreasing time order ending before hour(dt)
@@ -110,13 +123,14 @@ struct NextStopTimeData {
                                                       const DateTime dt,
                                                       const StopEvent stop_event) const {
         if (stop_event == StopEvent::pick_up) {
-            return departure[jpp_idx].prev_stop_time_range(dt);
+            return departure.prev_stop_time_range(jpp_idx, dt);
         } else {
-            return arrival[jpp_idx].prev_stop_time_range(dt);
+            return arrival.prev_stop_time_range(jpp_idx, dt);
         }
     }
 
 private:
+    using VjMap = std::unordered_map<const type::VehicleJourney*, const type::VehicleJourney*>;
     struct Departure {
         DateTime get_time(const type::StopTime& st) const;
         bool is_valid(const type::StopTime& st) const;
@@ -125,39 +139,63 @@ private:
         DateTime get_time(const type::StopTime& st) const;
         bool is_valid(const type::StopTime& st) const;
     };
-    // This structure allow to iterate on stop times in the interesting order
+    // This structure allow to iterate on stop times in the interesting order.
+    //
+    // The stop times of all the jpps are stored in the same vectors, the ones of a jpp being
+    // contiguous, so that the searches stay on a few cache lines and that there is no
+    // allocation per jpp.
     template <typename Getter>
     struct TimesStopTimes {
-        // times is sorted according to cmp
+        // the stop times of a jpp are stop_times[first, last)
+        struct Range {
+            uint32_t first = 0;
+            uint32_t last = 0;
+        };
+        // for each jpp, times is sorted according to cmp on its range
         // for all i, cmp.get_time(stop_times[i]) == times[i]
         std::vector<DateTime> times;
         std::vector<const type::StopTime*> stop_times;
+        IdxMap<JourneyPatternPoint, Range> ranges;
         Getter getter;
 
         // Returns the range of stop times
-        inline StopTimeIter stop_time_range() const {
-            return boost::make_iterator_range(stop_times.begin(), stop_times.end());
+        inline StopTimeIter stop_time_range(const JppIdx jpp_idx) const {
+            const auto& range = ranges[jpp_idx];
+            return boost::make_iterator_range(stop_times.begin() + range.first, stop_times.begin() + range.last);
         }
         // Returns the reverse range of stop times
-        inline StopTimeReverseIter reverse_stop_time_range() const {
-            return boost::make_iterator_range(stop_times.rbegin(), stop_times.rend());
+        inline StopTimeReverseIter reverse_stop_time_range(const JppIdx jpp_idx) const {
+            const auto& range = ranges[jpp_idx];
+            const auto rend = stop_times.rend() - range.first;
+            return boost::make_iterator_range(rend - (range.last - range.first), rend);
         }
         // Returns the range of stop times next to hour(dt)
-        inline StopTimeIter next_stop_time_range(const DateTime dt) const {
-            const auto it = boost::lower_bound(times, DateTimeUtils::hour(dt));
+        inline StopTimeIter next_stop_time_range(const JppIdx jpp_idx, const DateTime dt) const {
+            const auto& range = ranges[jpp_idx];
+            const auto it =
+                std::lower_bound(times.begin() + range.first, times.begin() + range.last, DateTimeUtils::hour(dt));
             const auto idx = it - times.begin();
-            return boost::make_iterator_range(stop_times.begin() + idx, stop_times.end());
+            return boost::make_iterator_range(stop_times.begin() + idx, stop_times.begin() + range.last);
         }
         // Returns the range of stop times previous to hour(dt)
-        inline StopTimeReverseIter prev_stop_time_range(const DateTime dt) const {
-            const auto it = boost::upper_bound(times, DateTimeUtils::hour(dt));
+        inline StopTimeReverseIter prev_stop_time_range(const JppIdx jpp_idx, const DateTime dt) const {
+            const auto& range = ranges[jpp_idx];
+            const auto it =
+                std::upper_bound(times.begin() + range.first, times.begin() + range.last, DateTimeUtils::hour(dt));
             const auto idx = it - times.begin();
-            return boost::make_iterator_range(stop_times.rend() - idx, stop_times.rend());
+            return boost::make_iterator_range(stop_times.rend() - idx, stop_times.rend() - range.first);
         }
-        void init(const JourneyPattern& jp, const JourneyPatternPoint& jpp);
+        void assign(const JourneyPatternContainer& jp_container);
+        // add the stop times of a jpp, must be called after assign
+        void add(const JppIdx jpp_idx, const JourneyPattern& jp, const JourneyPatternPoint& jpp);
+        // add the stop times of previous_jpp_idx in previous, with the vehicle journeys replaced according to new_vjs
+        void add_from(const JppIdx jpp_idx,
+                      const TimesStopTimes& previous,
+                      const JppIdx previous_jpp_idx,
+                      const VjMap& new_vjs);
     };
-    IdxMap<JourneyPatternPoint, TimesStopTimes<Departure>> departure;
-    IdxMap<JourneyPatternPoint, TimesStopTimes<Arrival>> arrival;
+    TimesStopTimes<Departure> departure;
+    TimesStopTimes<Arrival> arrival;
 };
 
 struct NextStopTime : public NextStopTimeInterface {
@@ -245,6 +283,10 @@ struct CachedNextStopTime : public NextStopTimeInterface {
                                                               const bool check_freq,
                                                               const boost::optional<DateTime>&) const override;
 
+    // The cached (datetime, stop time) of the vehicles leaving (resp. arriving at) the jpp, in increasing time order
+    boost::iterator_range<vDtSt::const_iterator> departures(const JppIdx& jpp_idx) const { return departure[jpp_idx]; }
+    boost::iterator_range<vDtSt::const_iterator> arrivals(const JppIdx& jpp_idx) const { return arrival[jpp_idx]; }
+
 private:
     // This structure provide the same interface as a vDtStByJpp, but
     // in a condensed and read only view.
@@ -284,7 +326,8 @@ private:
 };
 
 struct CachedNextStopTimeManager {
-    explicit CachedNextStopTimeManager(const dataRAPTOR& dataRaptor, size_t max_cache) : lru({dataRaptor}, max_cache) {}
+    explicit CachedNextStopTimeManager(const dataRAPTOR& dataRaptor, size_t max_cache)
+        : lru({dataRaptor, previous_caches}, max_cache) {}
     CachedNextStopTimeManager& operator=(CachedNextStopTimeManager&&) = default;
     ~CachedNextStopTimeManager();
 
@@ -293,18 +336,45 @@ struct CachedNextStopTimeManager {
                                                    const type::AccessibiliteParams& accessibilite_params);
 
     size_t get_nb_cache_miss() const { return lru.get_nb_cache_miss(); }
-    void warmup(const CachedNextStopTimeManager& other) { this->lru.warmup(other.lru); }
+    size_t get_nb_calls() const { return lru.get_nb_calls(); }
     size_t get_max_size() const { return lru.get_max_size(); }
 
+    /** Compute the caches of the keys loaded from `other` that are still alive
+     *
+     *  The caches of `other` are taken from what it has loaded, not from its lru, and given to the
+     *  creator with their key: `other` is not called while it is warmed up from.
+     *  As the lru warmup, the keys are loaded from the least to the most recently used one, and only
+     *  the max_cache most recently used ones are loaded.
+     */
+    void warmup(const CachedNextStopTimeManager& other);
+
 private:
+    using PreviousCaches = std::map<CachedNextStopTimeKey, std::shared_ptr<const CachedNextStopTime>>;
+
     struct CacheCreator {
         using argument_type = const CachedNextStopTimeKey&;
         using result_type = CachedNextStopTime;
         const dataRAPTOR& dataRaptor;
-        CacheCreator(const dataRAPTOR& d) : dataRaptor(d) {}
+        // only filled during the warmup: the caches of the previous manager by key
+        std::shared_ptr<const PreviousCaches> previous_caches;
+        CacheCreator(const dataRAPTOR& d, std::shared_ptr<const PreviousCaches> previous)
+            : dataRaptor(d), previous_caches(std::move(previous)) {}
         CachedNextStopTime operator()(const CachedNextStopTimeKey& key) const;
     };
 
+    std::shared_ptr<const CachedNextStopTime> load(const CachedNextStopTimeKey& key);
+
+    struct LoadedCache {
+        std::weak_ptr<const CachedNextStopTime> cache;
+        size_t last_use;  // number of loads when the key was last loaded
+    };
+
+    // the caches returned by load, without keeping them alive once the lru and the requests have released them
+    std::unique_ptr<std::mutex> loaded_mutex = std::make_unique<std::mutex>();
+    std::map<CachedNextStopTimeKey, LoadedCache> loaded;
+    size_t nb_loads = 0;
+    std::shared_ptr<PreviousCaches> previous_caches = std::make_shared<PreviousCaches>();
+    // declared last: its creator shares previous_caches
     ConcurrentLru<CacheCreator> lru;
 };
 
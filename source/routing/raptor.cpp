@@ -38,9 +38,14 @@ www.navitia.io
 #include <boost/functional/hash.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/algorithm/find_if.hpp>
+#include <boost/range/algorithm/reverse.hpp>
+#include <boost/range/algorithm/sort.hpp>
+#include <boost/range/algorithm_ext/erase.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 
 #include <chrono>
+#include <exception>
+#include <future>
 
 namespace navitia {
 namespace routing {
@@ -52,6 +57,65 @@ DateTime limit_bound(const bool clockwise, const DateTime departure_datetime, co
     return clockwise ? std::min(depart_clockwise, bound) : std::max(depart_anticlockwise, bound);
 }
 
+void TargetPruning::init(const map_stop_point_duration& destinations,
+                         const size_t nb_stop_points,
+                         const bool c,
+                         const DateTime departure_datetime,
+                         const boost::optional<navitia::time_duration>& direct_path_dur) {
+    targets = &destinations;
+    clockwise = c;
+    is_target.resize(nb_stop_points);
+    is_target.reset();
+    min_fallback = destinations.empty() ? 0 : std::numeric_limits<DateTime>::max();
+    for (const auto& dest : destinations) {
+        is_target.set(dest.first.val);
+        min_fallback = std::min(min_fallback, DateTime(dest.second.total_seconds()));
+    }
+    bounds.clear();
+    if (direct_path_dur) {
+        const DateTime dur = direct_path_dur->total_seconds();
+        add_bound({clockwise ? departure_datetime + dur : departure_datetime - dur, dur});
+    }
+}
+
+void TargetPruning::reset() {
+    targets = nullptr;
+    bounds.clear();
+}
+
+bool TargetPruning::is_dominated(const DateTime dt, const DateTime walking) const {
+    if (bounds.empty()) {
+        return false;
+    }
+    const DateTime best_dt = clockwise ? dt + min_fallback : dt - min_fallback;
+    const DateTime best_walking = walking + min_fallback;
+    for (const auto& bound : bounds) {
+        if (better(bound.dt, best_dt) && bound.walking <= best_walking) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TargetPruning::add_arrival(const SpIdx sp_idx, const DateTime dt, const DateTime walking) {
+    if (!targets || !is_target[sp_idx.val]) {
+        return;
+    }
+    const DateTime fallback = targets->find(sp_idx)->second.total_seconds();
+    add_bound({clockwise ? dt + fallback : dt - fallback, walking + fallback});
+}
+
+void TargetPruning::add_bound(const Bound& bound) {
+    for (const auto& b : bounds) {
+        if (!better(bound.dt, b.dt) && b.walking <= bound.walking) {
+            return;
+        }
+    }
+    boost::remove_erase_if(bounds,
+                           [&](const Bound& b) { return !better(b.dt, bound.dt) && bound.walking <= b.walking; });
+    bounds.push_back(bound);
+}
+
 /*
  * Check if the given vj is valid for the given datetime,
  * If it is for every stoptime of the vj,
@@ -97,8 +161,9 @@ bool RAPTOR::apply_vj_extension(const Visitor& v,
             Label& best_label = best_labels[sp_idx];
             Label& working_label = working_labels[sp_idx];
 
-            if (v.comp(workingDt, best_label.dt_pt)
-                || (workingDt == best_label.dt_pt && working_walking_duration < best_label.walking_duration_pt)) {
+            if ((v.comp(workingDt, best_label.dt_pt)
+                 || (workingDt == best_label.dt_pt && working_walking_duration < best_label.walking_duration_pt))
+                && !target_pruning.is_dominated(workingDt, working_walking_duration)) {
                 LOG4CPLUS_TRACE(raptor_logger, "Updating label dt count : "
                                                    << count << " sp " << data.pt_data->stop_points[sp_idx.val]->uri
                                                    << " from " << iso_string(working_label.dt_pt, data) << " to "
@@ -111,6 +176,8 @@ bool RAPTOR::apply_vj_extension(const Visitor& v,
                 BOOST_ASSERT(working_walking_duration != DateTimeUtils::not_valid);
                 best_label.dt_pt = workingDt;
                 best_label.walking_duration_pt = working_walking_duration;
+                improved_pt_sps.set(sp_idx.val);
+                target_pruning.add_arrival(sp_idx, workingDt, working_walking_duration);
                 result = true;
             }
         }
@@ -125,19 +192,17 @@ bool RAPTOR::foot_path(const Visitor& v) {
     auto& working_labels = labels[count];
     const auto& cnx_list = v.clockwise() ? data.dataRaptor->connections.forward_connections
                                          : data.dataRaptor->connections.backward_connections;
+    improved_transfer_sps.reset();
 
-    for (const auto sp_cnx : cnx_list) {
-        // for all stop point, we check if we can improve the stop points they are in connection with
-        const auto& sp_idx = sp_cnx.first;
+    // for all stop point improved during this round, we check if we can improve the stop points they are in
+    // connection with
+    for (auto sp = improved_pt_sps.find_first(); sp != boost::dynamic_bitset<>::npos;
+         sp = improved_pt_sps.find_next(sp)) {
+        const SpIdx sp_idx = SpIdx(sp);
         const Label& working_label = working_labels[sp_idx];
-
-        if (!is_dt_initialized(working_label.dt_pt)) {
-            continue;
-        }
-
         const DateTime start_connection_date = working_label.dt_pt;
 
-        for (const auto& conn : sp_cnx.second) {
+        for (const auto& conn : cnx_list[sp_idx]) {
             const SpIdx destination_sp_idx = conn.sp_idx;
             const DateTime end_connection_date = v.combine(start_connection_date, conn.duration);
             const DateTime candidate_walking_duration = working_label.walking_duration_pt + conn.walking_duration;
@@ -145,9 +210,10 @@ bool RAPTOR::foot_path(const Visitor& v) {
             Label& destination_working_label = working_labels[destination_sp_idx];
             Label& destination_best_label = best_labels[destination_sp_idx];
 
-            if (v.comp(end_connection_date, destination_best_label.dt_transfer)
-                || (end_connection_date == destination_best_label.dt_transfer
-                    && candidate_walking_duration < destination_best_label.walking_duration_transfer)) {
+            if ((v.comp(end_connection_date, destination_best_label.dt_transfer)
+                 || (end_connection_date == destination_best_label.dt_transfer
+                     && candidate_walking_duration < destination_best_label.walking_duration_transfer))
+                && !target_pruning.is_dominated(end_connection_date, candidate_walking_duration)) {
                 LOG4CPLUS_TRACE(raptor_logger,
                                 "Updating label transfer count : "
                                     << count << " sp " << data.pt_data->stop_points[destination_sp_idx.val]->uri
@@ -162,21 +228,19 @@ bool RAPTOR::foot_path(const Visitor& v) {
                 destination_working_label.walking_duration_transfer = candidate_walking_duration;
                 destination_best_label.dt_transfer = end_connection_date;
                 destination_best_label.walking_duration_transfer = candidate_walking_duration;
+                improved_transfer_sps.set(destination_sp_idx.val);
                 result = true;
             }
         }
     }
 
-    for (const auto sp_jpps : jpps_from_sp) {
-        const auto& working_label = working_labels[sp_jpps.first];
-        if (!is_dt_initialized(working_label.dt_transfer)) {
-            continue;
-        }
-
+    for (auto sp = improved_transfer_sps.find_first(); sp != boost::dynamic_bitset<>::npos;
+         sp = improved_transfer_sps.find_next(sp)) {
         // we mark the jpp order
-        for (const auto& jpp : sp_jpps.second) {
+        for (const auto& jpp : jpps_from_sp[SpIdx(sp)]) {
             if (v.comp(jpp.order, Q[jpp.jp_idx])) {
                 Q[jpp.jp_idx] = jpp.order;
+                marked_jps.set(jpp.jp_idx.val);
             }
         }
     }
@@ -185,15 +249,22 @@ bool RAPTOR::foot_path(const Visitor& v) {
 }
 
 void RAPTOR::clear(const bool clockwise, const DateTime bound) {
+    target_pruning.reset();
     const int queue_value = clockwise ? std::numeric_limits<int>::max() : -1;
     Q.assign(data.dataRaptor->jp_container.get_jps_values(), queue_value);
+    marked_jps.reset();
     if (labels.empty()) {
         labels.resize(5);
+        labels_usage.nb_rounds = labels.size();
     }
+    // the rounds not reached since the last reset in the same direction are still clean
+    const size_t nb_dirty_rounds =
+        labels_usage.clockwise == clockwise ? std::min(labels_usage.nb_rounds, labels.size()) : labels.size();
     const Labels& clean_labels = clockwise ? data.dataRaptor->labels_const : data.dataRaptor->labels_const_reverse;
-    for (auto& lbl_list : labels) {
-        lbl_list = clean_labels;
+    for (size_t round = 0; round < nb_dirty_rounds; ++round) {
+        labels[round] = clean_labels;
     }
+    labels_usage = {0, clockwise};
 
     best_labels.fill_values(bound, bound, DateTimeUtils::not_valid, DateTimeUtils::not_valid);
 }
@@ -202,6 +273,7 @@ void RAPTOR::init(const map_stop_point_duration& dep,
                   const DateTime bound,
                   const bool clockwise,
                   const type::Properties& properties) {
+    labels_usage.nb_rounds = std::max<size_t>(labels_usage.nb_rounds, 1);
     for (const auto& sp_dt : dep) {
         if (!get_sp(sp_dt.first)->accessible(properties)) {
             continue;
@@ -220,8 +292,10 @@ void RAPTOR::init(const map_stop_point_duration& dep,
         for (const auto& jpp : jpps_from_sp[sp_dt.first]) {
             if (clockwise && Q[jpp.jp_idx] > jpp.order) {
                 Q[jpp.jp_idx] = jpp.order;
+                marked_jps.set(jpp.jp_idx.val);
             } else if (!clockwise && Q[jpp.jp_idx] < jpp.order) {
                 Q[jpp.jp_idx] = jpp.order;
+                marked_jps.set(jpp.jp_idx.val);
             }
         }
     }
@@ -273,7 +347,9 @@ void RAPTOR::first_raptor_loop(const map_stop_point_duration& departures,
                                const uint32_t max_transfers,
                                const type::AccessibiliteParams& accessibilite_params,
                                const bool clockwise,
-                               const boost::optional<boost::posix_time::ptime>& current_datetime) {
+                               const boost::optional<boost::posix_time::ptime>& current_datetime,
+                               const map_stop_point_duration* destinations,
+                               const boost::optional<navitia::time_duration>& direct_path_dur) {
     const DateTime bound = limit_bound(clockwise, departure_datetime, bound_limit);
 
     auto next_st_type = choose_next_stop_time_type(clockwise ? departure_datetime : bound, current_datetime);
@@ -281,6 +357,10 @@ void RAPTOR::first_raptor_loop(const map_stop_point_duration& departures,
     set_next_stop_time(departure_datetime, rt_level, bound, accessibilite_params, clockwise, next_st_type);
 
     clear(clockwise, bound);
+    if (destinations) {
+        target_pruning.init(*destinations, data.pt_data->stop_points.size(), clockwise, departure_datetime,
+                            direct_path_dur);
+    }
     init(departures, departure_datetime, clockwise, accessibilite_params.properties);
 
     boucleRAPTOR(accessibilite_params, clockwise, rt_level, max_transfers);
@@ -443,22 +523,214 @@ std::vector<Path> RAPTOR::compute_all(const map_stop_point_duration& departures,
     return from_journeys_to_path(journeys);
 }
 
-RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& departures,
-                                              const map_stop_point_duration& destinations,
-                                              const DateTime& departure_datetime,
-                                              const nt::RTLevel rt_level,
-                                              const navitia::time_duration& arrival_transfer_penalty,
-                                              const navitia::time_duration& walking_transfer_penalty,
-                                              const DateTime& bound,
-                                              const uint32_t max_transfers,
-                                              const type::AccessibiliteParams& accessibilite_params,
-                                              bool clockwise,
-                                              const boost::optional<navitia::time_duration>& direct_path_dur,
-                                              const size_t max_extra_second_pass,
-                                              const boost::optional<boost::posix_time::ptime>& current_datetime) {
-    auto start_raptor = std::chrono::system_clock::now();
+void RAPTOR::second_pass(const std::vector<StartingPointSndPhase>& starting_points,
+                         Solutions& solutions,
+                         const map_stop_point_duration& departures,
+                         const map_stop_point_duration& destinations,
+                         const DateTime& departure_datetime,
+                         const nt::RTLevel rt_level,
+                         const navitia::time_duration& arrival_transfer_penalty,
+                         const navitia::time_duration& walking_transfer_penalty,
+                         const uint32_t max_transfers,
+                         const type::AccessibiliteParams& accessibilite_params,
+                         const bool clockwise,
+                         const size_t max_extra_second_pass) {
+    const auto& calc_dep = clockwise ? departures : destinations;
+
+    // As we do a backward raptor, the bound computed during the first
+    // pass can be used in the second pass.  The arrival at a stop
+    // point (as in best_labels_transfers) is a bound to the get in
+    // (as in best_labels_pt) in the second pass.  Then, we can reuse
+    // these bounds, modulo an off by one because of strict comparison
+    // on best_labels.
+    swap(labels, first_pass_labels);
+    std::swap(labels_usage, first_pass_labels_usage);
+
+    // durations and transfers are swapped for the 2nd pass as we are going backward in time
+    auto best_labels_for_snd_pass = best_labels;
+    best_labels_for_snd_pass.swap_pt_and_transfer();
+
+    snd_pass_best_labels(clockwise, best_labels_for_snd_pass);
+    init_best_pts_snd_pass(calc_dep, departure_datetime, clockwise, best_labels_for_snd_pass);
 
-    // auto solutions = ParetoFront<Journey, Dominates /*, JourneyParetoFrontVisitor*/>(Dominates(clockwise));
+    LOG4CPLUS_TRACE(raptor_logger, "starting points 2nd phase " << std::endl
+                                                                << print_starting_points_snd_phase(starting_points));
+
+    const size_t nb_threads = std::max<size_t>(nb_snd_pass_threads, 1);
+    if (nb_threads > 1) {
+        init_snd_pass_raptors(nb_threads - 1);
+    }
+
+    // The second passes are run by batches of nb_threads starting points, each helper adding its journeys to its
+    // own pool.  Once the batch is done, the starting points are taken again in their order, as the sequential
+    // loop would: a starting point dominated by the solutions merged so far is dropped and is not counted in the
+    // extra second passes, else its journeys are merged.  The result does not depend on nb_threads.
+    size_t nb_snd_pass = 0, nb_useless = 0, last_usefull_2nd_pass = 0, supplementary_2nd_pass = 0;
+    const auto dominated = [&](const StartingPointSndPhase& start) {
+        if (start.has_priority) {
+            return false;
+        }
+        Journey fake_journey = convert_to_bound(start, clockwise);
+        return solutions.contains_better_than(fake_journey);
+    };
+    std::vector<const StartingPointSndPhase*> batch;
+    std::vector<Solutions> helper_solutions;
+    std::vector<std::future<void>> helpers;
+    auto start_it = starting_points.begin();
+    while (start_it != starting_points.end()) {
+        // the starting points already dominated are skipped, and no more points than the extra second passes left
+        // are taken
+        batch.clear();
+        size_t nb_extra_in_batch = 0;
+        for (; start_it != starting_points.end() && batch.size() < nb_threads; ++start_it) {
+            const auto& start = *start_it;
+            LOG4CPLUS_TRACE(raptor_logger, std::endl
+                                               << "Second pass from " << get_sp(start.sp_idx)->uri
+                                               << "   count : " << start.count);
+            if (dominated(start)) {
+                LOG4CPLUS_TRACE(raptor_logger, "already found a better solution than the fake journey from "
+                                                   << get_sp(start.sp_idx)->uri);
+                continue;
+            }
+            if (!start.has_priority) {
+                if (supplementary_2nd_pass + nb_extra_in_batch >= max_extra_second_pass) {
+                    break;
+                }
+                ++nb_extra_in_batch;
+            }
+            batch.push_back(&start);
+        }
+        if (batch.empty()) {
+            if (start_it != starting_points.end()) {
+                LOG4CPLUS_DEBUG(raptor_logger, "max second pass reached");
+            }
+            break;
+        }
+
+        // the first starting point is run by the calling thread directly on the solutions
+        helper_solutions.assign(batch.size() - 1,
+                                Solutions(Dominates(clockwise, arrival_transfer_penalty, walking_transfer_penalty)));
+        helpers.clear();
+        for (size_t i = 1; i < batch.size(); ++i) {
+            RAPTOR* helper = snd_pass_raptors[i - 1].get();
+            const StartingPointSndPhase* start = batch[i];
+            const DateTime start_dt = first_pass_labels[start->count][start->sp_idx].dt_pt;
+            Solutions* helper_solution = &helper_solutions[i - 1];
+            helpers.push_back(snd_pass_pool->push([&, helper, start, start_dt, helper_solution]() {
+                helper->snd_pass_from(*start, start_dt, best_labels_for_snd_pass, *helper_solution, departures,
+                                      destinations, departure_datetime, rt_level, arrival_transfer_penalty,
+                                      max_transfers, accessibilite_params, clockwise);
+            }));
+        }
+        const auto& first = *batch.front();
+        if (!first.has_priority) {
+            ++supplementary_2nd_pass;
+        }
+        std::exception_ptr error;
+        try {
+            snd_pass_from(first, first_pass_labels[first.count][first.sp_idx].dt_pt, best_labels_for_snd_pass,
+                          solutions, departures, destinations, departure_datetime, rt_level, arrival_transfer_penalty,
+                          max_transfers, accessibilite_params, clockwise);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        ++nb_snd_pass;
+        // the helpers use the labels of the first pass, they must all be over before anything is rethrown
+        for (const auto& helper : helpers) {
+            helper.wait();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        for (auto& helper : helpers) {
+            // rethrows the exceptions of the helper threads
+            helper.get();
+        }
+
+        for (size_t i = 1; i < batch.size(); ++i) {
+            const auto& start = *batch[i];
+            if (dominated(start)) {
+                LOG4CPLUS_TRACE(raptor_logger, "second pass from " << get_sp(start.sp_idx)->uri
+                                                                   << " dominated by the previous ones of its batch");
+                continue;
+            }
+            if (!start.has_priority) {
+                ++supplementary_2nd_pass;
+            }
+            for (const auto& journey : helper_solutions[i - 1].get_pool()) {
+                solutions.add(journey);
+            }
+            ++nb_snd_pass;
+        }
+
+        LOG4CPLUS_DEBUG(raptor_logger, "end of raptor loop body, nb of solutions : " << solutions.size());
+    }
+
+    LOG4CPLUS_DEBUG(raptor_logger, "[2nd pass] number of 2nd pass = "
+                                       << nb_snd_pass << " / " << starting_points.size() << " (nb useless = "
+                                       << nb_useless << ", last usefull try = " << last_usefull_2nd_pass << ")");
+}
+
+void RAPTOR::snd_pass_from(const StartingPointSndPhase& start,
+                           const DateTime& start_dt,
+                           const Labels& snd_pass_best_labels,
+                           Solutions& solutions,
+                           const map_stop_point_duration& departures,
+                           const map_stop_point_duration& destinations,
+                           const DateTime& departure_datetime,
+                           const nt::RTLevel rt_level,
+                           const navitia::time_duration& arrival_transfer_penalty,
+                           const uint32_t max_transfers,
+                           const type::AccessibiliteParams& accessibilite_params,
+                           const bool clockwise) {
+    clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
+    map_stop_point_duration init_map;
+    init_map[start.sp_idx] = 0_s;
+    best_labels = snd_pass_best_labels;
+    init(init_map, start_dt, !clockwise, accessibilite_params.properties);
+    boucleRAPTOR(accessibilite_params, !clockwise, rt_level, max_transfers);
+
+    read_solutions(*this, solutions, !clockwise, departure_datetime, departures, destinations, rt_level,
+                   accessibilite_params, arrival_transfer_penalty, start);
+}
+
+WorkerPool* RAPTOR::heat_map_pool() {
+    if (nb_heat_map_threads <= 1) {
+        return nullptr;
+    }
+    if (!heat_map_workers || heat_map_workers->size() != nb_heat_map_threads - 1) {
+        heat_map_workers = std::make_unique<WorkerPool>(nb_heat_map_threads - 1);
+    }
+    return heat_map_workers.get();
+}
+
+void RAPTOR::init_snd_pass_raptors(const size_t nb_raptors) {
+    while (snd_pass_raptors.size() < nb_raptors) {
+        snd_pass_raptors.push_back(std::make_unique<RAPTOR>(data));
+    }
+    if (!snd_pass_pool || snd_pass_pool->size() != nb_raptors) {
+        snd_pass_pool = std::make_unique<WorkerPool>(nb_raptors);
+    }
+    // the helpers share the next stop times and the validity computed for the request, the validity is only copied
+    // when it has changed since the previous request
+    for (auto& helper : snd_pass_raptors) {
+        helper->next_st = next_st;
+        if (validity_key && helper->validity_key && *helper->validity_key == *validity_key) {
+            continue;
+        }
+        helper->valid_journey_patterns = valid_journey_patterns;
+        helper->valid_stop_points = valid_stop_points;
+        helper->jpps_from_sp = jpps_from_sp;
+        helper->validity_key = validity_key;
+    }
+}
+
+// solutions pool, initialized with the direct path (if any) so that it can dominate the pt journeys
+static Solutions make_solutions(const DateTime& departure_datetime,
+                                const navitia::time_duration& arrival_transfer_penalty,
+                                const navitia::time_duration& walking_transfer_penalty,
+                                const bool clockwise,
+                                const boost::optional<navitia::time_duration>& direct_path_dur) {
     auto dominator = Dominates(clockwise, arrival_transfer_penalty, walking_transfer_penalty);
     auto solutions = Solutions(dominator);
 
@@ -474,12 +746,33 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
         }
         solutions.add(j);
     }
+    return solutions;
+}
+
+RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& departures,
+                                              const map_stop_point_duration& destinations,
+                                              const DateTime& departure_datetime,
+                                              const nt::RTLevel rt_level,
+                                              const navitia::time_duration& arrival_transfer_penalty,
+                                              const navitia::time_duration& walking_transfer_penalty,
+                                              const DateTime& bound,
+                                              const uint32_t max_transfers,
+                                              const type::AccessibiliteParams& accessibilite_params,
+                                              bool clockwise,
+                                              const boost::optional<navitia::time_duration>& direct_path_dur,
+                                              const size_t max_extra_second_pass,
+                                              const boost::optional<boost::posix_time::ptime>& current_datetime) {
+    auto start_raptor = std::chrono::system_clock::now();
+
+    auto solutions = make_solutions(departure_datetime, arrival_transfer_penalty, walking_transfer_penalty, clockwise,
+                                    direct_path_dur);
 
     const auto& calc_dep = clockwise ? departures : destinations;
     const auto& calc_dest = clockwise ? destinations : departures;
 
     first_raptor_loop(calc_dep, departure_datetime, rt_level, bound, max_transfers, accessibilite_params, clockwise,
-                      current_datetime);
+                      current_datetime, &calc_dest, direct_path_dur);
+    target_pruning.reset();
 
     LOG4CPLUS_TRACE(raptor_logger, "labels after first pass : " << std::endl << print_all_labels());
 
@@ -492,85 +785,256 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
     // the earliest (resp. tardiest) departure (resp arrival)
     // datetime.  For each count and arrival (resp departure), we
     // launch a backward raptor.
-    //
-    // As we do a backward raptor, the bound computed during the first
-    // pass can be used in the second pass.  The arrival at a stop
-    // point (as in best_labels_transfers) is a bound to the get in
-    // (as in best_labels_pt) in the second pass.  Then, we can reuse
-    // these bounds, modulo an off by one because of strict comparison
-    // on best_labels.
     auto starting_points = make_starting_points_snd_phase(*this, calc_dest, accessibilite_params, clockwise);
-    swap(labels, first_pass_labels);
+    second_pass(starting_points, solutions, departures, destinations, departure_datetime, rt_level,
+                arrival_transfer_penalty, walking_transfer_penalty, max_transfers, accessibilite_params, clockwise,
+                max_extra_second_pass);
 
-    const auto inrows_labels = best_labels.inrow_labels();
+    auto end_raptor = std::chrono::system_clock::now();
+    LOG4CPLUS_DEBUG(raptor_logger,
+                    "[2nd pass] Run times: 1st pass = "
+                        << std::chrono::duration_cast<std::chrono::milliseconds>(end_first_pass - start_raptor).count()
+                        << ", 2nd pass = "
+                        << std::chrono::duration_cast<std::chrono::milliseconds>(end_raptor - end_first_pass).count());
 
-    auto best_labels_for_snd_pass = Labels(
-        // durations and transfers are swapped for the 2nd pass as we are going backward in time
-        inrows_labels[1],   // dt transfers as pts
-        inrows_labels[0],   // dt pts as transfers
-        inrows_labels[3],   // walking duration transfers as walking duration
-        inrows_labels[2]);  // walking duration pts as walking duration transfers
+    return solutions.get_pool();
+}
 
-    snd_pass_best_labels(clockwise, best_labels_for_snd_pass);
-    init_best_pts_snd_pass(calc_dep, departure_datetime, clockwise, best_labels_for_snd_pass);
+std::vector<RAPTOR::Journeys> RAPTOR::compute_one_to_many_journeys(
+    const map_stop_point_duration& shared,
+    const std::vector<map_stop_point_duration>& destinations_list,
+    const DateTime& departure_datetime,
+    const nt::RTLevel rt_level,
+    const navitia::time_duration& arrival_transfer_penalty,
+    const navitia::time_duration& walking_transfer_penalty,
+    const DateTime& bound,
+    const uint32_t max_transfers,
+    const type::AccessibiliteParams& accessibilite_params,
+    bool clockwise,
+    const std::vector<boost::optional<navitia::time_duration>>& direct_path_durs,
+    const size_t max_extra_second_pass,
+    const boost::optional<boost::posix_time::ptime>& current_datetime) {
+    std::vector<Journeys> res;
+    if (destinations_list.empty()) {
+        return res;
+    }
+    auto start_raptor = std::chrono::system_clock::now();
 
-    LOG4CPLUS_TRACE(raptor_logger, "starting points 2nd phase " << std::endl
-                                                                << print_starting_points_snd_phase(starting_points));
+    first_raptor_loop(shared, departure_datetime, rt_level, bound, max_transfers, accessibilite_params, clockwise,
+                      current_datetime);
 
-    size_t nb_snd_pass = 0, nb_useless = 0, last_usefull_2nd_pass = 0, supplementary_2nd_pass = 0;
-    for (const auto& start : starting_points) {
-        navitia::type::StopPoint* start_stop_point = data.pt_data->stop_points[start.sp_idx.val];
+    // the second passes overwrite the labels, the count and best_labels: the first pass state is
+    // kept to be restored before each of them
+    const Labels first_pass_best_labels = best_labels;
+    const unsigned first_pass_count = count;
+
+    for (size_t i = 0; i < destinations_list.size(); ++i) {
+        if (i > 0) {
+            swap(labels, first_pass_labels);
+            std::swap(labels_usage, first_pass_labels_usage);
+            best_labels = first_pass_best_labels;
+            count = first_pass_count;
+        }
+        const auto& others = destinations_list[i];
+        const auto& departures = clockwise ? shared : others;
+        const auto& destinations = clockwise ? others : shared;
+        const auto direct_path_dur = i < direct_path_durs.size() ? direct_path_durs[i] : boost::none;
+
+        auto solutions = make_solutions(departure_datetime, arrival_transfer_penalty, walking_transfer_penalty,
+                                        clockwise, direct_path_dur);
+        auto starting_points = make_starting_points_snd_phase(*this, others, accessibilite_params, clockwise);
+        second_pass(starting_points, solutions, departures, destinations, departure_datetime, rt_level,
+                    arrival_transfer_penalty, walking_transfer_penalty, max_transfers, accessibilite_params, clockwise,
+                    max_extra_second_pass);
+        res.push_back(solutions.get_pool());
+    }
 
-        LOG4CPLUS_TRACE(raptor_logger, std::endl
-                                           << "Second pass from " << start_stop_point->uri
-                                           << "   count : " << start.count);
+    auto end_raptor = std::chrono::system_clock::now();
+    LOG4CPLUS_DEBUG(raptor_logger,
+                    "[one to many] Run time for " << destinations_list.size() << " destinations = "
+                                                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                         end_raptor - start_raptor)
+                                                         .count());
+    return res;
+}
 
-        if (!start.has_priority) {
-            Journey fake_journey = convert_to_bound(start, clockwise);
+RAPTOR::Journeys RAPTOR::compute_mc_journeys(const map_stop_point_duration& departures,
+                                             const map_stop_point_duration& destinations,
+                                             const DateTime& departure_datetime,
+                                             const nt::RTLevel rt_level,
+                                             const navitia::time_duration& arrival_transfer_penalty,
+                                             const navitia::time_duration& walking_transfer_penalty,
+                                             const DateTime& bound,
+                                             const uint32_t max_transfers,
+                                             const type::AccessibiliteParams& accessibilite_params,
+                                             const boost::optional<navitia::time_duration>& direct_path_dur,
+                                             const boost::optional<boost::posix_time::ptime>& current_datetime) {
+    auto start_raptor = std::chrono::system_clock::now();
 
-            if (solutions.contains_better_than(fake_journey)) {
-                LOG4CPLUS_TRACE(raptor_logger,
-                                "already found a better solution than the fake journey from " << start_stop_point->uri);
-                continue;
-            }
+    const DateTime bound_limit = limit_bound(true, departure_datetime, bound);
+    set_next_stop_time(departure_datetime, rt_level, bound_limit, accessibilite_params, true,
+                       choose_next_stop_time_type(departure_datetime, current_datetime));
 
-            ++supplementary_2nd_pass;
+    McRaptor mc_raptor(*this, mc_params);
+    auto journeys = mc_raptor.compute(departures, destinations, departure_datetime, bound_limit, rt_level,
+                                      arrival_transfer_penalty, walking_transfer_penalty, max_transfers,
+                                      accessibilite_params.vehicle_properties, direct_path_dur);
 
-            if (supplementary_2nd_pass > max_extra_second_pass) {
-                LOG4CPLUS_DEBUG(raptor_logger, "max second pass reached");
-                break;
+    auto end_raptor = std::chrono::system_clock::now();
+    LOG4CPLUS_DEBUG(raptor_logger,
+                    "[mc] Run time = "
+                        << std::chrono::duration_cast<std::chrono::milliseconds>(end_raptor - start_raptor).count()
+                        << ", " << journeys.size() << " journeys");
+
+    return journeys;
+}
+
+std::vector<DateTime> RAPTOR::profile_datetimes(const map_stop_point_duration& departures,
+                                                const DateTime& departure_datetime,
+                                                const DateTime& timeframe_limit,
+                                                const nt::RTLevel rt_level,
+                                                const type::AccessibiliteParams& accessibilite_params,
+                                                const bool clockwise) const {
+    std::vector<DateTime> res = {departure_datetime};
+    for (const auto& sp_dur : departures) {
+        if (!get_sp(sp_dur.first)->accessible(accessibilite_params.properties)) {
+            continue;
+        }
+        const DateTime sn_dur = sp_dur.second.total_seconds();
+        for (const auto& jpp : jpps_from_sp[sp_dur.first]) {
+            if (clockwise) {
+                // every vehicle leaving the stop point that can be boarded from departure_datetime to timeframe_limit
+                DateTime dt = departure_datetime + sn_dur;
+                while (true) {
+                    const auto st_dt = next_st->next_stop_time(StopEvent::pick_up, jpp.idx, dt, true, rt_level,
+                                                               accessibilite_params.vehicle_properties);
+                    if (st_dt.first == nullptr || st_dt.second > timeframe_limit + sn_dur) {
+                        break;
+                    }
+                    res.push_back(st_dt.second - sn_dur);
+                    dt = st_dt.second + 1;
+                }
+            } else {
+                // every vehicle arriving at the stop point from timeframe_limit to departure_datetime
+                if (departure_datetime < sn_dur) {
+                    continue;
+                }
+                DateTime dt = departure_datetime - sn_dur;
+                while (true) {
+                    const auto st_dt = next_st->next_stop_time(StopEvent::drop_off, jpp.idx, dt, false, rt_level,
+                                                               accessibilite_params.vehicle_properties);
+                    if (st_dt.first == nullptr || st_dt.second + sn_dur < timeframe_limit) {
+                        break;
+                    }
+                    res.push_back(st_dt.second + sn_dur);
+                    if (st_dt.second == 0) {
+                        break;
+                    }
+                    dt = st_dt.second - 1;
+                }
             }
         }
+    }
+
+    // rRAPTOR scans the datetimes from the worst one to departure_datetime, so that the labels of
+    // a run are valid bounds for the next one
+    boost::sort(res);
+    res.erase(std::unique(res.begin(), res.end()), res.end());
+    if (clockwise) {
+        boost::reverse(res);
+    }
+    return res;
+}
+
+RAPTOR::ProfileJourneys RAPTOR::compute_profile_journeys(
+    const map_stop_point_duration& departures,
+    const map_stop_point_duration& destinations,
+    const DateTime& departure_datetime,
+    const DateTime& timeframe_limit,
+    const nt::RTLevel rt_level,
+    const navitia::time_duration& arrival_transfer_penalty,
+    const navitia::time_duration& walking_transfer_penalty,
+    const DateTime& bound_limit,
+    const uint32_t max_transfers,
+    const type::AccessibiliteParams& accessibilite_params,
+    bool clockwise,
+    const boost::optional<navitia::time_duration>& direct_path_dur,
+    const size_t max_extra_second_pass,
+    const boost::optional<boost::posix_time::ptime>& current_datetime) {
+    auto start_raptor = std::chrono::system_clock::now();
 
-        const auto& working_labels = first_pass_labels[start.count];
+    const auto& calc_dep = clockwise ? departures : destinations;
+    const auto& calc_dest = clockwise ? destinations : departures;
 
-        clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
-        map_stop_point_duration init_map;
-        init_map[start.sp_idx] = 0_s;
-        best_labels = best_labels_for_snd_pass;
-        const Label& working_label = working_labels[start.sp_idx];
-        init(init_map, working_label.dt_pt, !clockwise, accessibilite_params.properties);
-        boucleRAPTOR(accessibilite_params, !clockwise, rt_level, max_transfers);
+    // the labels are shared by all the runs, so the bound must be valid for the worst one
+    const DateTime bound = limit_bound(clockwise, timeframe_limit, bound_limit);
 
-        read_solutions(*this, solutions, !clockwise, departure_datetime, departures, destinations, rt_level,
-                       accessibilite_params, arrival_transfer_penalty, start);
+    // the cache of next stop times only covers journeys starting the same day
+    const auto next_st_type =
+        DateTimeUtils::date(timeframe_limit) == DateTimeUtils::date(departure_datetime)
+            ? choose_next_stop_time_type(clockwise ? departure_datetime : bound, current_datetime)
+            : NEXT_STOPTIME_TYPE::UNCACHED;
+    set_next_stop_time(departure_datetime, rt_level, bound, accessibilite_params, clockwise, next_st_type);
 
-        LOG4CPLUS_DEBUG(raptor_logger, "end of raptor loop body, nb of solutions : " << solutions.size());
+    const auto datetimes =
+        profile_datetimes(calc_dep, departure_datetime, timeframe_limit, rt_level, accessibilite_params, clockwise);
+    LOG4CPLUS_DEBUG(raptor_logger, "[rRAPTOR] " << datetimes.size() << " departures to scan");
 
-        ++nb_snd_pass;
+    clear(clockwise, bound);
+    const int queue_value = clockwise ? std::numeric_limits<int>::max() : -1;
+    const DateTime worst_dt = clockwise ? DateTimeUtils::inf : DateTimeUtils::min;
+
+    // dt_pt of the destinations for each count after the previous run, a second pass is
+    // only needed from the ones improved by the current run
+    std::vector<std::vector<DateTime>> previous_dest_labels;
+
+    ProfileJourneys result;
+    size_t nb_runs_with_solutions = 0;
+    for (const auto dt : datetimes) {
+        Q.assign(data.dataRaptor->jp_container.get_jps_values(), queue_value);
+        marked_jps.reset();
+        init(calc_dep, dt, clockwise, accessibilite_params.properties);
+        boucleRAPTOR(accessibilite_params, clockwise, rt_level, max_transfers);
+
+        previous_dest_labels.resize(labels.size(), std::vector<DateTime>(calc_dest.size(), worst_dt));
+        auto starting_points = make_starting_points_snd_phase(*this, calc_dest, accessibilite_params, clockwise);
+        boost::remove_erase_if(starting_points, [&](const StartingPointSndPhase& start) {
+            const auto dest_pos = calc_dest.find(start.sp_idx) - calc_dest.begin();
+            return labels[start.count][start.sp_idx].dt_pt == previous_dest_labels[start.count][dest_pos];
+        });
+        for (unsigned c = 1; c <= count && c < labels.size(); ++c) {
+            size_t dest_pos = 0;
+            for (const auto& dest : calc_dest) {
+                previous_dest_labels[c][dest_pos++] = labels[c][dest.first].dt_pt;
+            }
+        }
+
+        if (starting_points.empty()) {
+            continue;
+        }
+
+        // the second pass overwrites best_labels and the second pass labels,
+        // they are restored for the next run
+        const Labels first_pass_best_labels = best_labels;
+        auto solutions =
+            make_solutions(dt, arrival_transfer_penalty, walking_transfer_penalty, clockwise, direct_path_dur);
+        second_pass(starting_points, solutions, departures, destinations, dt, rt_level, arrival_transfer_penalty,
+                    walking_transfer_penalty, max_transfers, accessibilite_params, clockwise, max_extra_second_pass);
+        swap(labels, first_pass_labels);
+        std::swap(labels_usage, first_pass_labels_usage);
+        best_labels = first_pass_best_labels;
+
+        result.emplace_back(dt, solutions.get_pool());
+        ++nb_runs_with_solutions;
     }
 
-    LOG4CPLUS_DEBUG(raptor_logger, "[2nd pass] number of 2nd pass = "
-                                       << nb_snd_pass << " / " << starting_points.size() << " (nb useless = "
-                                       << nb_useless << ", last usefull try = " << last_usefull_2nd_pass << ")");
     auto end_raptor = std::chrono::system_clock::now();
-    LOG4CPLUS_DEBUG(raptor_logger,
-                    "[2nd pass] Run times: 1st pass = "
-                        << std::chrono::duration_cast<std::chrono::milliseconds>(end_first_pass - start_raptor).count()
-                        << ", 2nd pass = "
-                        << std::chrono::duration_cast<std::chrono::milliseconds>(end_raptor - end_first_pass).count());
-
-    return solutions.get_pool();
+    LOG4CPLUS_DEBUG(raptor_logger, "[rRAPTOR] " << nb_runs_with_solutions << " / " << datetimes.size()
+                                                << " runs with new solutions, run time = "
+                                                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                       end_raptor - start_raptor)
+                                                       .count());
+    return result;
 }
 
 void RAPTOR::isochrone(const map_stop_point_duration& departures,
@@ -670,9 +1134,14 @@ void RAPTOR::set_valid_jp_and_jpp(uint32_t date,
                                   const std::vector<std::string>& forbidden,
                                   const std::vector<std::string>& allowed,
                                   const nt::RTLevel rt_level) {
+    ValidityKey key{date, rt_level, accessibilite_params.properties, forbidden, allowed};
+    if (validity_key && *validity_key == key) {
+        return;
+    }
+
     const auto& jp_container = data.dataRaptor->jp_container;
     valid_journey_patterns = data.dataRaptor->jp_validity_patterns[rt_level][date];
-    boost::dynamic_bitset<> valid_journey_pattern_points(jp_container.nb_jpps());
+    valid_journey_pattern_points.resize(jp_container.nb_jpps());
     valid_journey_pattern_points.set();
     valid_stop_points.set();
 
@@ -696,27 +1165,20 @@ void RAPTOR::set_valid_jp_and_jpp(uint32_t date,
         valid_stop_points &= allowed_objs.sps;
     }
 
-    // filter accessibility
-    if (accessibilite_params.properties.any()) {
-        for (const auto* sp : data.pt_data->stop_points) {
-            if (sp->accessible(accessibilite_params.properties)) {
-                continue;
-            }
-            valid_stop_points.set(sp->idx, false);
-            for (const auto& jpp : data.dataRaptor->jpps_from_sp[SpIdx(*sp)]) {
-                valid_journey_pattern_points.set(jpp.idx.val, false);
-            }
+    // filter accessibility: keep only the stop points having every required property
+    const auto& property_masks = data.dataRaptor->property_masks;
+    for (size_t property = 0; property < accessibilite_params.properties.size(); ++property) {
+        if (accessibilite_params.properties[property]) {
+            valid_stop_points &= property_masks.sps[property];
+            valid_journey_pattern_points &= property_masks.jpps[property];
         }
     }
 
-    // propagate the invalid jp in their jpp
-    for (JpIdx jp_idx = JpIdx(0); jp_idx.val < valid_journey_patterns.size(); ++jp_idx.val) {
-        if (valid_journey_patterns[jp_idx.val]) {
-            continue;
-        }
-        const auto& jp = jp_container.get(jp_idx);
-        for (const auto& jpp_idx : jp.jpps) {
-            valid_journey_pattern_points.set(jpp_idx.val, false);
+    // propagate the invalid jp in their jpp, in one sequential pass over the jpps
+    const auto& jpps = jp_container.get_jpps_values();
+    for (size_t jpp_idx = 0; jpp_idx < jpps.size(); ++jpp_idx) {
+        if (!valid_journey_patterns[jpps[jpp_idx].jp_idx.val]) {
+            valid_journey_pattern_points.reset(jpp_idx);
         }
     }
 
@@ -724,8 +1186,9 @@ void RAPTOR::set_valid_jp_and_jpp(uint32_t date,
     // jpps.  Thanks to that, we don't need to check
     // valid_journey_pattern[_point]s as we iterate only on the
     // feasible ones.
-    jpps_from_sp = data.dataRaptor->jpps_from_sp;
-    jpps_from_sp.filter_jpps(valid_journey_pattern_points);
+    jpps_from_sp.assign_filtered(data.dataRaptor->jpps_from_sp, valid_journey_pattern_points);
+
+    validity_key = std::move(key);
 }
 
 template <typename Visitor>
@@ -739,6 +1202,7 @@ void RAPTOR::raptor_loop(Visitor visitor,
     while (continue_algorithm && count <= max_transfers) {
         ++count;
         continue_algorithm = false;
+        labels_usage.nb_rounds = std::max<size_t>(labels_usage.nb_rounds, count + 1);
         if (count == labels.size()) {
             if (visitor.clockwise()) {
                 this->labels.push_back(this->data.dataRaptor->labels_const);
@@ -748,20 +1212,24 @@ void RAPTOR::raptor_loop(Visitor visitor,
         }
         const auto& prec_labels = labels[count - 1];
         auto& working_labels = labels[this->count];
+        improved_pt_sps.reset();
         /*
          * We need to store it so we can apply stay_in after applying normal vjs
          * We want to do it, to favoritize normal vj against stay_in vjs
          */
-        for (auto q_elt : Q) {
-            /// We will scan the journey_pattern q_elt.first, starting from its stop numbered q_elt.second
+        // only the journey patterns marked by the previous round are scanned, in increasing
+        // index order as a scan of the whole Q would do
+        for (auto jp = marked_jps.find_first(); jp != boost::dynamic_bitset<>::npos; jp = marked_jps.find_next(jp)) {
+            /// We will scan the journey_pattern jp_idx, starting from its stop numbered q_order
 
-            const JpIdx jp_idx = q_elt.first;
+            const JpIdx jp_idx = JpIdx(jp);
+            int& q_order = Q[jp_idx];
 
             const RouteIdx route_idx = data.dataRaptor->jp_container.get(jp_idx).route_idx;
 
-            /// q_elt.second == visitor.init_queue_item() means that
+            /// q_order == visitor.init_queue_item() means that
             /// this journey_pattern is marked "not to be scanned"
-            if (q_elt.second != visitor.init_queue_item()) {
+            if (q_order != visitor.init_queue_item()) {
                 /// we begin scanning the journey_pattern as if we were not yet aboard a vehicle
                 bool is_onboard = false;
                 DateTime workingDt = visitor.worst_datetime();
@@ -778,7 +1246,7 @@ void RAPTOR::raptor_loop(Visitor visitor,
                 LOG4CPLUS_TRACE(raptor_logger, " Scanning line  " << data.pt_data->routes[route_idx.val]->line->uri);
 
                 const auto& jpps_to_explore =
-                    visitor.jpps_from_order(data.dataRaptor->jpps_from_jp, jp_idx, q_elt.second);
+                    visitor.jpps_from_order(data.dataRaptor->jpps_from_jp, jp_idx, q_order);
                 for (const dataRAPTOR::JppsFromJp::Jpp& jpp : jpps_to_explore) {
                     if (is_onboard) {
                         ++it_st;
@@ -799,8 +1267,8 @@ void RAPTOR::raptor_loop(Visitor visitor,
                         if (st.valid_end(visitor.clockwise())
                             && (l_zone == std::numeric_limits<uint16_t>::max() || l_zone != st.local_traffic_zone)
                             && has_better_label
-                            && valid_stop_points[jpp.sp_idx.val])  // we need to check the accessibility
-                        {
+                            && valid_stop_points[jpp.sp_idx.val]  // we need to check the accessibility
+                            && !target_pruning.is_dominated(workingDt, working_walking_duration)) {
                             LOG4CPLUS_TRACE(raptor_logger,
                                             "Updating label dt "
                                                 << "count : " << count << " sp "
@@ -817,6 +1285,8 @@ void RAPTOR::raptor_loop(Visitor visitor,
                             BOOST_ASSERT(working_walking_duration != DateTimeUtils::not_valid);
                             best_label.dt_pt = workingDt;
                             best_label.walking_duration_pt = working_walking_duration;
+                            improved_pt_sps.set(jpp.sp_idx.val);
+                            target_pruning.add_arrival(jpp.sp_idx, workingDt, working_walking_duration);
                             continue_algorithm = true;
                         }
                     }
@@ -942,8 +1412,9 @@ void RAPTOR::raptor_loop(Visitor visitor,
                 }
             }
             /// mark the journey_pattern as visited, no need to explore it in the next round
-            q_elt.second = visitor.init_queue_item();
+            q_order = visitor.init_queue_item();
         }
+        marked_jps.reset();
         if (continue_algorithm) {
             continue_algorithm = this->foot_path(visitor);
         }
@@ -1051,7 +1522,7 @@ std::string RAPTOR::print_all_labels() {
     return output.str();
 }
 
-std::string RAPTOR::print_starting_points_snd_phase(std::vector<StartingPointSndPhase>& starting_points) {
+std::string RAPTOR::print_starting_points_snd_phase(const std::vector<StartingPointSndPhase>& starting_points) {
     std::ostringstream output;
     for (auto start_point : starting_points) {
         navitia::type::StopPoint* stop_point = data.pt_data->stop_points[start_point.sp_idx.val];
@@ -45,13 +45,16 @@ www.navitia.io
 #include "routing.h"
 #include "routing/journey.h"
 #include "routing/labels.h"
+#include "routing/mc_raptor.h"
 #include "utils/idx_map.h"
 #include "utils/timer.h"
 #include "dataraptor.h"
 #include "raptor_utils.h"
+#include "type/worker_pool.h"
 
 #include "dataraptor.h"
 #include <unordered_map>
+#include <memory>
 #include <queue>
 #include <limits>
 
@@ -68,6 +71,45 @@ struct StartingPointSndPhase {
     bool has_priority;
 };
 
+/** Pruning of the first pass by the arrivals already found at the destinations.
+ *
+ *  A label (dt, walking) of round k can only lead to journeys reaching the destinations not
+ *  before dt + min_fallback, with at least walking + min_fallback of walking and at least k
+ *  transfers.  When an arrival already found at the destinations (or the direct path) is
+ *  strictly better on the datetime and not worse on the walking, all these journeys are
+ *  dominated (as by the Dom filter of the starting points of the second pass) and the label
+ *  does not need to be set.
+ */
+struct TargetPruning {
+    struct Bound {
+        DateTime dt;
+        DateTime walking;
+    };
+
+    void init(const map_stop_point_duration& destinations,
+              const size_t nb_stop_points,
+              const bool clockwise,
+              const DateTime departure_datetime,
+              const boost::optional<navitia::time_duration>& direct_path_dur);
+    void reset();
+
+    bool enabled() const { return targets != nullptr; }
+    bool is_dominated(const DateTime dt, const DateTime walking) const;
+    /// to be called each time the dt_pt of a stop point is improved
+    void add_arrival(const SpIdx sp_idx, const DateTime dt, const DateTime walking);
+
+private:
+    void add_bound(const Bound& bound);
+    bool better(const DateTime lhs, const DateTime rhs) const { return clockwise ? lhs < rhs : lhs > rhs; }
+
+    const map_stop_point_duration* targets = nullptr;
+    boost::dynamic_bitset<> is_target;
+    bool clockwise = true;
+    DateTime min_fallback = 0;
+    // pareto front of the arrivals found
+    std::vector<Bound> bounds;
+};
+
 /** Worker Raptor : une instance par thread, les données sont modifiées par le calcul */
 struct RAPTOR {
     enum class NEXT_STOPTIME_TYPE {
@@ -76,6 +118,9 @@ struct RAPTOR {
     };
 
     using Journeys = std::list<Journey>;
+    /// Journeys found by a profile (rRAPTOR) search, grouped by the departure
+    /// (or arrival if anticlockwise) datetime they have been computed for
+    using ProfileJourneys = std::vector<std::pair<DateTime, Journeys>>;
 
     const navitia::type::Data& data;
 
@@ -89,6 +134,15 @@ struct RAPTOR {
     std::vector<Labels> labels;
     std::vector<Labels> first_pass_labels;
 
+    /// Rounds of labels (resp. first_pass_labels) that may have been written since they were
+    /// last reset, and the direction of that reset. clear() only resets those rounds.
+    struct LabelsUsage {
+        size_t nb_rounds = 0;
+        bool clockwise = true;
+    };
+    LabelsUsage labels_usage;
+    LabelsUsage first_pass_labels_usage;
+
     /// Contains the best arrival (or departure time) for each stoppoint
     Labels best_labels;
 
@@ -99,10 +153,53 @@ struct RAPTOR {
     dataRAPTOR::JppsFromSp jpps_from_sp;
     /// Order of the first journey_pattern point of each journey_pattern
     IdxMap<JourneyPattern, int> Q;
+    /// Journey patterns whose Q is set, i.e. the ones to scan during the next round
+    boost::dynamic_bitset<> marked_jps;
 
     // set to store if the stop_point is valid
     boost::dynamic_bitset<> valid_stop_points;
 
+    /// Parameters of the last set_valid_jp_and_jpp. Consecutive requests often share them
+    /// (same day, no filter), and then the valid sets are not computed again.
+    struct ValidityKey {
+        uint32_t date;
+        nt::RTLevel rt_level;
+        type::Properties properties;
+        std::vector<std::string> forbidden;
+        std::vector<std::string> allowed;
+        bool operator==(const ValidityKey& other) const {
+            return date == other.date && rt_level == other.rt_level && properties == other.properties
+                   && forbidden == other.forbidden && allowed == other.allowed;
+        }
+    };
+    boost::optional<ValidityKey> validity_key;
+    /// Valid jpps of the last set_valid_jp_and_jpp, kept to avoid an allocation per request
+    boost::dynamic_bitset<> valid_journey_pattern_points;
+
+    /// Stop points whose dt_pt (resp. dt_transfer) label has been improved during the current round.
+    /// Only those need to be propagated by foot_path, which allows labels to be reused between runs.
+    boost::dynamic_bitset<> improved_pt_sps;
+    boost::dynamic_bitset<> improved_transfer_sps;
+
+    /// Set only during the first pass of compute_all_journeys
+    TargetPruning target_pruning;
+
+    /// When true, requests with a timeframe are computed in one rRAPTOR sweep
+    /// (see compute_profile_journeys) instead of one full RAPTOR per journey.
+    bool profile_mode = false;
+
+    /// When true, clockwise requests are computed by the multi-criteria raptor
+    /// (see compute_mc_journeys) with the criteria of mc_params.
+    bool mc_mode = false;
+    McRaptorParams mc_params;
+
+    /// Number of threads running the second pass of a request, each one on its own labels.
+    /// With 1, the second pass is run by the calling thread only.
+    size_t nb_snd_pass_threads = 1;
+
+    /// Number of threads rasterizing a heat map, each one on its own tiles of the grid.
+    size_t nb_heat_map_threads = 1;
+
     log4cplus::Logger raptor_logger;
 
     explicit RAPTOR(const navitia::type::Data& data)
@@ -112,7 +209,11 @@ struct RAPTOR {
           count(0),
           valid_journey_patterns(data.dataRaptor->jp_container.nb_jps()),
           Q(data.dataRaptor->jp_container.get_jps_values()),
+          marked_jps(data.dataRaptor->jp_container.nb_jps()),
           valid_stop_points(data.pt_data->stop_points.size()),
+          valid_journey_pattern_points(data.dataRaptor->jp_container.nb_jpps()),
+          improved_pt_sps(data.pt_data->stop_points.size()),
+          improved_transfer_sps(data.pt_data->stop_points.size()),
           raptor_logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("raptor"))) {
         labels.assign(10, data.dataRaptor->labels_const);
         first_pass_labels.assign(10, data.dataRaptor->labels_const);
@@ -179,6 +280,71 @@ struct RAPTOR {
                                   const size_t max_extra_second_pass = 0,
                                   const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none);
 
+    /** One-to-many RAPTOR: compute the journeys from departures to each set of destinations of
+     *  `destinations_list` (resp. to arrivals from each set of origins if anticlockwise).
+     *
+     *  The first pass, from the shared side, is done once for all the sets, without the target
+     *  pruning that would be specific to one of them, then a second pass is run per set.
+     *  The result has one element per set, with the direct path of direct_path_durs (if any).
+     *  set_valid_jp_and_jpp must have been called before.
+     */
+    std::vector<Journeys> compute_one_to_many_journeys(
+        const map_stop_point_duration& shared,
+        const std::vector<map_stop_point_duration>& destinations_list,
+        const DateTime& departure_datetime,
+        const nt::RTLevel rt_level,
+        const navitia::time_duration& arrival_transfer_penalty,
+        const navitia::time_duration& walking_transfer_penalty,
+        const DateTime& bound = DateTimeUtils::inf,
+        const uint32_t max_transfers = 10,
+        const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams(),
+        bool clockwise = true,
+        const std::vector<boost::optional<navitia::time_duration>>& direct_path_durs = {},
+        const size_t max_extra_second_pass = 0,
+        const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none);
+
+    /** Multi-criteria RAPTOR (McRAPTOR): compute the Pareto optimal journeys on the arrival,
+     *  the number of transfers, the walking duration and the criteria of mc_params, in one
+     *  clockwise pass without second pass.
+     *  set_valid_jp_and_jpp must have been called before.
+     */
+    Journeys compute_mc_journeys(const map_stop_point_duration& departures,
+                                 const map_stop_point_duration& destinations,
+                                 const DateTime& departure_datetime,
+                                 const nt::RTLevel rt_level,
+                                 const navitia::time_duration& arrival_transfer_penalty,
+                                 const navitia::time_duration& walking_transfer_penalty,
+                                 const DateTime& bound = DateTimeUtils::inf,
+                                 const uint32_t max_transfers = 10,
+                                 const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams(),
+                                 const boost::optional<navitia::time_duration>& direct_path_dur = boost::none,
+                                 const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none);
+
+    /** Range RAPTOR (rRAPTOR): compute the journeys of every departure (resp. arrival)
+     *  between departure_datetime and timeframe_limit.
+     *
+     *  The boarding times at the departures are scanned from timeframe_limit back to
+     *  departure_datetime, and the labels are kept from one departure to the previous one,
+     *  so that each run only explores what the earlier departure improves.
+     *  The second pass is launched only for the destinations that have been improved.
+     *  set_valid_jp_and_jpp must have been called before.
+     */
+    ProfileJourneys compute_profile_journeys(
+        const map_stop_point_duration& departures,
+        const map_stop_point_duration& destinations,
+        const DateTime& departure_datetime,
+        const DateTime& timeframe_limit,
+        const nt::RTLevel rt_level,
+        const navitia::time_duration& arrival_transfer_penalty,
+        const navitia::time_duration& walking_transfer_penalty,
+        const DateTime& bound = DateTimeUtils::inf,
+        const uint32_t max_transfers = 10,
+        const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams(),
+        bool clockwise = true,
+        const boost::optional<navitia::time_duration>& direct_path_dur = boost::none,
+        const size_t max_extra_second_pass = 0,
+        const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none);
+
     template <class T>
     std::vector<Path> from_journeys_to_path(const T& journeys) const {
         std::vector<Path> result;
@@ -254,12 +420,18 @@ struct RAPTOR {
                            const uint32_t max_transfers,
                            const type::AccessibiliteParams& accessibilite_params,
                            const bool clockwise,
-                           const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none);
+                           const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none,
+                           const map_stop_point_duration* destinations = nullptr,
+                           const boost::optional<navitia::time_duration>& direct_path_dur = boost::none);
 
     ~RAPTOR() = default;
 
     std::string print_all_labels();
-    std::string print_starting_points_snd_phase(std::vector<StartingPointSndPhase>& starting_points);
+    std::string print_starting_points_snd_phase(const std::vector<StartingPointSndPhase>& starting_points);
+
+    /// Threads rasterizing the heat maps with the calling thread, kept between the requests.
+    /// nullptr if nb_heat_map_threads is 1
+    WorkerPool* heat_map_pool();
 
 private:
     NEXT_STOPTIME_TYPE choose_next_stop_time_type(
@@ -271,6 +443,52 @@ private:
                             const type::AccessibiliteParams& accessibilite_params,
                             const bool clockwise,
                             const NEXT_STOPTIME_TYPE next_st_type);
+
+    /// Backward raptor from each starting point found by the first pass, solutions are added to `solutions`
+    void second_pass(const std::vector<StartingPointSndPhase>& starting_points,
+                     Solutions& solutions,
+                     const map_stop_point_duration& departures,
+                     const map_stop_point_duration& destinations,
+                     const DateTime& departure_datetime,
+                     const nt::RTLevel rt_level,
+                     const navitia::time_duration& arrival_transfer_penalty,
+                     const navitia::time_duration& walking_transfer_penalty,
+                     const uint32_t max_transfers,
+                     const type::AccessibiliteParams& accessibilite_params,
+                     const bool clockwise,
+                     const size_t max_extra_second_pass);
+
+    /// Backward raptor from one starting point, starting at start_dt with the bounds of snd_pass_best_labels
+    void snd_pass_from(const StartingPointSndPhase& start,
+                       const DateTime& start_dt,
+                       const Labels& snd_pass_best_labels,
+                       Solutions& solutions,
+                       const map_stop_point_duration& departures,
+                       const map_stop_point_duration& destinations,
+                       const DateTime& departure_datetime,
+                       const nt::RTLevel rt_level,
+                       const navitia::time_duration& arrival_transfer_penalty,
+                       const uint32_t max_transfers,
+                       const type::AccessibiliteParams& accessibilite_params,
+                       const bool clockwise);
+
+    /// Build (if needed) the raptors and the threads of the second pass helpers and give them the request's state
+    void init_snd_pass_raptors(const size_t nb_raptors);
+
+    /// Scratch raptors used by the helper threads of the second pass, kept between the requests
+    std::vector<std::unique_ptr<RAPTOR>> snd_pass_raptors;
+    /// Threads running the second passes of the helpers, kept between the requests
+    std::unique_ptr<WorkerPool> snd_pass_pool;
+    std::unique_ptr<WorkerPool> heat_map_workers;
+
+    /// Boarding (resp. alighting) datetimes at the departures between departure_datetime and
+    /// timeframe_limit, minus (resp. plus) the fallback duration, sorted in the rRAPTOR scan order
+    std::vector<DateTime> profile_datetimes(const map_stop_point_duration& departures,
+                                            const DateTime& departure_datetime,
+                                            const DateTime& timeframe_limit,
+                                            const nt::RTLevel rt_level,
+                                            const type::AccessibiliteParams& accessibilite_params,
+                                            const bool clockwise) const;
 };
 
 }  // namespace routing
@@ -46,6 +46,7 @@ www.navitia.io
 #include <boost/range/adaptor/indexed.hpp>
 
 #include <chrono>
+#include <map>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -113,6 +114,29 @@ static boost::optional<DateTime> get_timeframe_limit(const DateTime request_date
     return limit;
 }
 
+/**
+ * @brief filter the journeys found by raptor for the given request datetime
+ *
+ * Direct paths and journeys too late compared to the best one are removed and the backtracking
+ * journeys are modified (see modify_backtracking_journeys).
+ */
+static void filter_raptor_journeys(RAPTOR::Journeys& journeys,
+                                   const map_stop_point_duration& departures,
+                                   const map_stop_point_duration& destinations,
+                                   const DateTime request_dt,
+                                   const bool clockwise,
+                                   const double night_bus_filter_max_factor,
+                                   const int32_t night_bus_filter_base_factor) {
+    // Remove direct path
+    filter_direct_path(journeys);
+
+    // filter joureys that are too late.....with the magic formula...
+    NightBusFilter::Params params{request_dt, clockwise, night_bus_filter_max_factor, night_bus_filter_base_factor};
+    filter_late_journeys(journeys, params);
+
+    modify_backtracking_journeys(journeys, departures, destinations, clockwise);
+}
+
 /**
  * @brief internal function to call raptor in a loop
  */
@@ -172,33 +196,65 @@ static std::vector<Path> call_raptor(navitia::PbCreator& pb_creator,
         raptor.set_valid_jp_and_jpp(DateTimeUtils::date(request_date_secs), accessibilite_params, forbidden_uri,
                                     allowed_ids, rt_level);
 
-        do {
-            auto raptor_journeys = raptor.compute_all_journeys(
-                departures, destinations, request_date_secs, rt_level, arrival_transfer_penalty,
-                walking_transfer_penalty, bound, max_transfers, accessibilite_params, clockwise, direct_path_duration,
-                max_extra_second_pass, current_datetime);
-
+        // filter the journeys computed for the given request datetime and add them to the result
+        auto add_journeys = [&](RAPTOR::Journeys& raptor_journeys, const DateTime request_dt) {
             LOG4CPLUS_DEBUG(logger, "raptor found " << raptor_journeys.size() << " solutions");
 
-            // Remove direct path
-            filter_direct_path(raptor_journeys);
+            filter_raptor_journeys(raptor_journeys, departures, destinations, request_dt, clockwise,
+                                   night_bus_filter_max_factor, night_bus_filter_base_factor);
 
-            // filter joureys that are too late.....with the magic formula...
-            NightBusFilter::Params params{request_date_secs, clockwise, night_bus_filter_max_factor,
-                                          night_bus_filter_base_factor};
-            filter_late_journeys(raptor_journeys, params);
+            LOG4CPLUS_DEBUG(logger, "after filtering late journeys: " << raptor_journeys.size() << " solution(s) left");
 
-            modify_backtracking_journeys(raptor_journeys, departures, destinations, clockwise);
+            // filter the similar journeys
+            for (const auto& journey : raptor_journeys) {
+                journeys.insert(journey);
+            }
+        };
 
-            LOG4CPLUS_DEBUG(logger, "after filtering late journeys: " << raptor_journeys.size() << " solution(s) left");
+        bool continue_raptor = true;
+        if (raptor.profile_mode && timeframe_limit) {
+            // all the journeys of the timeframe are computed in one rRAPTOR sweep
+            auto profile_journeys = raptor.compute_profile_journeys(
+                departures, destinations, request_date_secs, *timeframe_limit, rt_level, arrival_transfer_penalty,
+                walking_transfer_penalty, bound, max_transfers, accessibilite_params, clockwise, direct_path_duration,
+                max_extra_second_pass, current_datetime);
+
+            RAPTOR::Journeys raptor_journeys;
+            for (auto& dt_journeys : profile_journeys) {
+                add_journeys(dt_journeys.second, dt_journeys.first);
+                raptor_journeys.splice(raptor_journeys.end(), dt_journeys.second);
+            }
+            nb_try++;
+            total_nb_journeys = journeys.size() + nb_direct_path;
 
             if (raptor_journeys.empty()) {
-                break;
+                continue_raptor = false;
+            } else {
+                // the next calls, if min_nb_journeys is not reached, start after the timeframe
+                const auto next_date_secs = prepare_next_call_for_raptor(raptor_journeys, clockwise);
+                request_date_secs = clockwise ? std::max(next_date_secs, *timeframe_limit)
+                                              : std::min(next_date_secs, *timeframe_limit);
+                continue_raptor = keep_going(total_nb_journeys, nb_try, clockwise, request_date_secs, min_nb_journeys,
+                                             timeframe_limit, max_transfers);
             }
+        }
 
-            // filter the similar journeys
-            for (const auto& journey : raptor_journeys) {
-                journeys.insert(journey);
+        while (continue_raptor) {
+            auto raptor_journeys =
+                raptor.mc_mode && clockwise
+                    ? raptor.compute_mc_journeys(departures, destinations, request_date_secs, rt_level,
+                                                 arrival_transfer_penalty, walking_transfer_penalty, bound,
+                                                 max_transfers, accessibilite_params, direct_path_duration,
+                                                 current_datetime)
+                    : raptor.compute_all_journeys(departures, destinations, request_date_secs, rt_level,
+                                                  arrival_transfer_penalty, walking_transfer_penalty, bound,
+                                                  max_transfers, accessibilite_params, clockwise,
+                                                  direct_path_duration, max_extra_second_pass, current_datetime);
+
+            add_journeys(raptor_journeys, request_date_secs);
+
+            if (raptor_journeys.empty()) {
+                break;
             }
 
             nb_try++;
@@ -208,8 +264,9 @@ static std::vector<Path> call_raptor(navitia::PbCreator& pb_creator,
             // Prepare next call for raptor with min_nb_journeys option
             request_date_secs = prepare_next_call_for_raptor(raptor_journeys, clockwise);
 
-        } while (keep_going(total_nb_journeys, nb_try, clockwise, request_date_secs, min_nb_journeys, timeframe_limit,
-                            max_transfers));
+            continue_raptor = keep_going(total_nb_journeys, nb_try, clockwise, request_date_secs, min_nb_journeys,
+                                         timeframe_limit, max_transfers);
+        }
 
         // create date time for next
         if (request_date_secs != to_datetime(datetime, raptor.data)) {
@@ -1143,7 +1200,7 @@ boost::optional<routing::map_stop_point_duration> get_stop_points(const type::En
             }
             const auto admin = data.geo_ref->admins[it_admin->second];
 
-            for (auto stop_area : admin->main_stop_areas) {
+            for (auto stop_area : data.pt_data->main_stop_areas(*admin)) {
                 for (auto stop_point : stop_area->stop_point_list) {
                     add_free_stop_point(stop_point, concerned_path_finder, result);
                 }
@@ -1162,7 +1219,7 @@ boost::optional<routing::map_stop_point_duration> get_stop_points(const type::En
     // we need to check if the admin has zone odt
     const auto& admins = find_admins(ep, data);
     for (const auto* admin : admins) {
-        for (const auto* odt_admin_stop_point : admin->odt_stop_points) {
+        for (const auto* odt_admin_stop_point : data.pt_data->odt_stop_points(*admin)) {
             add_free_stop_point(odt_admin_stop_point, concerned_path_finder, result);
         }
     }
@@ -1354,6 +1411,129 @@ void make_pt_response(navitia::PbCreator& pb_creator,
     }
 }
 
+std::vector<pbnavitia::Response> make_pt_batch_response(
+    navitia::PbCreator& pb_creator,
+    RAPTOR& raptor,
+    const std::vector<PtBatchItem>& items,
+    const uint64_t timestamp,
+    const bool clockwise,
+    const type::AccessibiliteParams& accessibilite_params,
+    const std::vector<std::string>& forbidden,
+    const std::vector<std::string>& allowed,
+    const type::RTLevel rt_level,
+    const navitia::time_duration& arrival_transfer_penalty,
+    const navitia::time_duration& walking_transfer_penalty,
+    const uint32_t max_duration,
+    const uint32_t max_transfers,
+    const uint32_t max_extra_second_pass,
+    const double night_bus_filter_max_factor,
+    const int32_t night_bus_filter_base_factor,
+    const uint32_t depth,
+    const boost::optional<boost::posix_time::ptime>& current_datetime) {
+    log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
+    std::vector<pbnavitia::Response> responses(items.size());
+
+    // each response is filled by pb_creator initialized with the context of the batch
+    const auto* data = pb_creator.data;
+    const auto now = pb_creator.now;
+    const auto action_period = pb_creator.action_period;
+    const bool disable_geojson = pb_creator.disable_geojson;
+    const bool disable_feedpublisher = pb_creator.disable_feedpublisher;
+    const bool disable_disruption = pb_creator.disable_disruption;
+    const std::string language = pb_creator.language;
+
+    auto datetimes = parse_datetimes(raptor, {timestamp}, pb_creator, clockwise);
+    if (pb_creator.has_error() || pb_creator.has_response_type(pbnavitia::DATE_OUT_OF_BOUNDS)) {
+        const auto& error_response = pb_creator.get_response();
+        for (auto& response : responses) {
+            response = error_response;
+        }
+        return responses;
+    }
+    const auto& datetime = datetimes.front();
+    const DateTime request_date_secs = to_datetime(datetime, raptor.data);
+    DateTime bound = clockwise ? DateTimeUtils::inf : DateTimeUtils::min;
+    if (max_duration != DateTimeUtils::inf) {
+        if (clockwise) {
+            bound = request_date_secs + max_duration;
+        } else {
+            bound = request_date_secs > max_duration ? request_date_secs - max_duration : 0;
+        }
+    }
+
+    raptor.set_valid_jp_and_jpp(DateTimeUtils::date(request_date_secs), accessibilite_params, forbidden, allowed,
+                                rt_level);
+
+    // the pairs are grouped by the side of the first pass of raptor
+    std::vector<map_stop_point_duration> others(items.size());
+    std::map<map_stop_point_duration, std::vector<size_t>> groups;
+    for (size_t i = 0; i < items.size(); ++i) {
+        auto departures = make_map_stop_point_duration(items[i].origins, raptor.data.pt_data->stop_points_map);
+        auto arrivals = make_map_stop_point_duration(items[i].destinations, raptor.data.pt_data->stop_points_map);
+        // as make_response, the pairs without any stop point on a side are not computed
+        if (departures.empty() || arrivals.empty()) {
+            pb_creator.init(data, now, action_period, disable_geojson, disable_feedpublisher, disable_disruption,
+                            language);
+            if (departures.empty() && arrivals.empty()) {
+                pb_creator.fill_pb_error(pbnavitia::Error::no_origin_nor_destination,
+                                         pbnavitia::NO_ORIGIN_NOR_DESTINATION_POINT,
+                                         "Public transport is not reachable from origin nor destination");
+            } else if (departures.empty()) {
+                pb_creator.fill_pb_error(pbnavitia::Error::no_origin, pbnavitia::NO_ORIGIN_POINT,
+                                         "Public transport is not reachable from origin");
+            } else {
+                pb_creator.fill_pb_error(pbnavitia::Error::no_destination, pbnavitia::NO_DESTINATION_POINT,
+                                         "Public transport is not reachable from destination");
+            }
+            responses[i] = pb_creator.get_response();
+            continue;
+        }
+        others[i] = clockwise ? std::move(arrivals) : std::move(departures);
+        groups[clockwise ? departures : arrivals].push_back(i);
+    }
+    LOG4CPLUS_DEBUG(logger, "batch of " << items.size() << " pt requests in " << groups.size() << " raptor calls");
+
+    for (const auto& group : groups) {
+        const auto& shared = group.first;
+        std::vector<map_stop_point_duration> others_list;
+        std::vector<boost::optional<navitia::time_duration>> direct_path_durs;
+        for (const auto i : group.second) {
+            others_list.push_back(others[i]);
+            direct_path_durs.push_back(items[i].direct_path_duration);
+        }
+        auto journeys_list = raptor.compute_one_to_many_journeys(
+            shared, others_list, request_date_secs, rt_level, arrival_transfer_penalty, walking_transfer_penalty,
+            bound, max_transfers, accessibilite_params, clockwise, direct_path_durs, max_extra_second_pass,
+            current_datetime);
+
+        for (size_t k = 0; k < group.second.size(); ++k) {
+            const auto i = group.second[k];
+            auto& raptor_journeys = journeys_list[k];
+            const auto& departures = clockwise ? shared : others[i];
+            const auto& destinations = clockwise ? others[i] : shared;
+
+            filter_raptor_journeys(raptor_journeys, departures, destinations, request_date_secs, clockwise,
+                                   night_bus_filter_max_factor, night_bus_filter_base_factor);
+            const JourneySet journeys(raptor_journeys.begin(), raptor_journeys.end());
+
+            auto pathes = raptor.from_journeys_to_path(journeys);
+            for (auto& path : pathes) {
+                path.request_time = datetime;
+            }
+
+            pb_creator.init(data, now, action_period, disable_geojson, disable_feedpublisher, disable_disruption,
+                            language);
+            make_pt_pathes(pb_creator, pathes, depth);
+            if (pb_creator.empty_journeys()) {
+                pb_creator.fill_pb_error(pbnavitia::Error::no_solution, pbnavitia::NO_SOLUTION,
+                                         "no solution found for this journey");
+            }
+            responses[i] = pb_creator.get_response();
+        }
+    }
+    return responses;
+}
+
 void filter_direct_path(RAPTOR::Journeys& journeys) {
     journeys.remove_if([](const Journey& j) { return !j.is_pt(); });
 }
@@ -1871,7 +2051,7 @@ void make_heat_map(navitia::PbCreator& pb_creator,
 
     auto heat_map = build_raster_isochrone(worker.geo_ref, end_speed, end_mode, isochrone_common->init_dt, raptor,
                                            isochrone_common->coord_origin, max_duration, clockwise,
-                                           isochrone_common->bound, resolution);
+                                           isochrone_common->bound, resolution, raptor.heat_map_pool());
     add_heat_map(heat_map, pb_creator, center, clockwise, isochrone_common->datetime);
 }
 
@@ -144,6 +144,47 @@ void make_pt_response(navitia::PbCreator& pb_creator,
                       const uint32_t depth = 1,
                       const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none);
 
+/// One origin/destination pair of a batch of pt requests (see make_pt_batch_response)
+struct PtBatchItem {
+    type::EntryPoints origins;
+    type::EntryPoints destinations;
+    boost::optional<navitia::time_duration> direct_path_duration;
+};
+
+/**
+ * @brief Used for batches of Pt requests in distributed mode sharing the same datetime and parameters
+ *
+ * The validity of the journey patterns is set once for the whole batch, and the pairs sharing their
+ * origins (destinations if anticlockwise) are computed by one one-to-many raptor.
+ * One response is returned per pair, in the order of the pairs: pb_creator is reinitialized (with
+ * its current context) for each of them.
+ * Unlike make_pt_response, raptor is called once per pair (no min_nb_journeys nor timeframe).
+ * The pairs without origin or destination get the no_origin, no_destination or
+ * no_origin_nor_destination error, as with make_response.
+ *
+ * Only used by the tests for now: the worker will dispatch to it once navitia-proto has a request
+ * for a batch of journeys.
+ */
+std::vector<pbnavitia::Response> make_pt_batch_response(
+    navitia::PbCreator& pb_creator,
+    RAPTOR& raptor,
+    const std::vector<PtBatchItem>& items,
+    const uint64_t timestamp,
+    const bool clockwise,
+    const type::AccessibiliteParams& accessibilite_params,
+    const std::vector<std::string>& forbidden,
+    const std::vector<std::string>& allowed,
+    const type::RTLevel rt_level,
+    const navitia::time_duration& arrival_transfer_penalty,
+    const navitia::time_duration& walking_transfer_penalty,
+    const uint32_t max_duration = std::numeric_limits<uint32_t>::max(),
+    const uint32_t max_transfers = std::numeric_limits<uint32_t>::max(),
+    const uint32_t max_extra_second_pass = 0,
+    const double night_bus_filter_max_factor = NightBusFilter::default_max_factor,
+    const int32_t night_bus_filter_base_factor = NightBusFilter::default_base_factor,
+    const uint32_t depth = 1,
+    const boost::optional<boost::posix_time::ptime>& current_datetime = boost::none);
+
 boost::optional<routing::map_stop_point_duration> get_stop_points(const type::EntryPoint& ep,
                                                                   const type::Data& data,
                                                                   georef::StreetNetwork& worker,
@@ -210,4 +210,21 @@ BOOST_AUTO_TEST_CASE(heat_map_test) {
     for (size_t i = 3; i < result.size(); i++) {
         BOOST_CHECK(result[i].is_pos_infinity());
     }
+
+    // the tiles of the grid rasterized by several threads give the same durations
+    for (const size_t nb_threads : {2, 4}) {
+        navitia::WorkerPool pool(nb_threads - 1);
+        const auto threaded_heat_map = fill_heat_map(box, height_step, width_step, *b.data->geo_ref, min_dist,
+                                                     max_duration, speed, distances, step, &pool);
+        for (size_t i = 0; i < step; i++) {
+            for (size_t j = 0; j < step; j++) {
+                BOOST_CHECK_EQUAL(threaded_heat_map.body[i].second[j], heat_map.body[i].second[j]);
+            }
+        }
+    }
+    raptor.nb_heat_map_threads = 4;
+    const auto threaded_isochrone = build_raster_isochrone(*b.data->geo_ref, speed, mode, init_dt, raptor, A,
+                                                           max_duration, true, bound, resolution,
+                                                           raptor.heat_map_pool());
+    BOOST_CHECK(threaded_isochrone == isochrone);
 }
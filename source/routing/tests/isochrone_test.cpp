@@ -214,4 +214,15 @@ BOOST_AUTO_TEST_CASE(build_ischrons_test) {
 #endif
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30[0].shape, isochrone_8h_8h30_9h[0].shape));
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30_9h[0].shape, isochrone_8h_8h30_9h[1].shape));
+
+    // the boundaries are built from the points reached within the longest duration only,
+    // they are the same as the single isochrones computed with their own bound
+    const auto single_9h = build_single_isochrone(raptor, b.data->pt_data->stop_points, true, coord_Paris,
+                                                  navitia::DateTimeUtils::set(0, "09:00"_t), d, speed, 3600);
+    const auto single_8h30 = build_single_isochrone(raptor, b.data->pt_data->stop_points, true, coord_Paris,
+                                                    navitia::DateTimeUtils::set(0, "08:30"_t), d, speed, 1800);
+    navitia::type::MultiPolygon single_8h30_9h;
+    boost::geometry::difference(single_9h, single_8h30, single_8h30_9h);
+    BOOST_CHECK(boost::geometry::equals(single_8h30, isochrone_8h30[0].shape));
+    BOOST_CHECK(boost::geometry::equals(single_8h30_9h, isochrone_8h30_9h[0].shape));
 }
@@ -0,0 +1,186 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_mc_raptor
+#include <boost/test/unit_test.hpp>
+#include "routing/raptor.h"
+#include "routing/mc_raptor.h"
+#include "ed/build_helper.h"
+#include "tests/utils_test.h"
+#include "utils/logger.h"
+
+#include <boost/range/algorithm/find_if.hpp>
+
+struct logger_initialized {
+    logger_initialized() {
+        navitia::init_logger();
+        auto raptor_logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("raptor"));
+        raptor_logger.setLogLevel(log4cplus::FATAL_LOG_LEVEL);
+        auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
+        logger.setLogLevel(log4cplus::FATAL_LOG_LEVEL);
+    }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+using namespace navitia;
+using namespace routing;
+
+namespace {
+
+RAPTOR::Journeys compute_mc(RAPTOR& raptor,
+                            const std::string& from,
+                            const std::string& to,
+                            const navitia::time_duration& transfer_penalty = 2_min) {
+    const type::PT_Data& d = *raptor.data.pt_data;
+    map_stop_point_duration departures, arrivals;
+    departures[SpIdx(*d.stop_points_map.at(from))] = {};
+    arrivals[SpIdx(*d.stop_points_map.at(to))] = {};
+    const auto departure_time = DateTimeUtils::set(0, "7:55"_t);
+    raptor.set_valid_jp_and_jpp(DateTimeUtils::date(departure_time), {}, {}, {}, type::RTLevel::Base);
+    return raptor.compute_mc_journeys(departures, arrivals, departure_time, type::RTLevel::Base, transfer_penalty,
+                                      transfer_penalty);
+}
+
+// arrival of each journey, sorted
+std::vector<DateTime> arrivals_of(const RAPTOR::Journeys& journeys) {
+    std::vector<DateTime> res;
+    for (const auto& j : journeys) {
+        res.push_back(j.arrival_dt);
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+}  // namespace
+
+/*
+ * A ---l1---> X (zone 2) ---> B   arrives at 8:30
+ * A ---l2---> Y ------------> B   arrives at 8:45
+ *
+ * l1 is faster but leaves the fare zone of A and B twice: without criteria only l1 is
+ * returned, counting the fare zone crossings both journeys are Pareto optimal.
+ */
+BOOST_AUTO_TEST_CASE(mc_raptor_fare_zone_crossings) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("l1")("A", "8:00"_t)("X", "8:15"_t)("B", "8:30"_t);
+        b.vj("l2")("A", "8:00"_t)("Y", "8:20"_t)("B", "8:45"_t);
+    });
+    type::PT_Data& d = *b.data->pt_data;
+    for (const auto* uri : {"A", "Y", "B"}) {
+        d.stop_points_map[uri]->fare_zone = "1";
+    }
+    d.stop_points_map["X"]->fare_zone = "2";
+
+    RAPTOR raptor(*b.data);
+    raptor.mc_mode = true;
+
+    auto res = compute_mc(raptor, "A", "B");
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res.front().arrival_dt, DateTimeUtils::set(0, "8:30"_t));
+    BOOST_CHECK_EQUAL(res.front().departure_dt, DateTimeUtils::set(0, "8:00"_t));
+    BOOST_REQUIRE_EQUAL(res.front().sections.size(), 1);
+
+    raptor.mc_params.criteria.push_back(make_mc_criterion("fare_zone_crossings"));
+    res = compute_mc(raptor, "A", "B");
+    const std::vector<DateTime> expected = {DateTimeUtils::set(0, "8:30"_t), DateTimeUtils::set(0, "8:45"_t)};
+    const auto arrivals = arrivals_of(res);
+    BOOST_CHECK_EQUAL_COLLECTIONS(arrivals.begin(), arrivals.end(), expected.begin(), expected.end());
+
+    // with bags of one label, the earliest arrival is still found
+    raptor.mc_params.max_bag_size = 1;
+    res = compute_mc(raptor, "A", "B");
+    BOOST_REQUIRE(!res.empty());
+    BOOST_CHECK_EQUAL(arrivals_of(res).front(), DateTimeUtils::set(0, "8:30"_t));
+}
+
+/*
+ * A ---l1 (no bike)---> B                       arrives at 8:30
+ * A ---l2---> C, C ---l3---> B (bikes accepted) arrives at 8:40
+ *
+ * Counting the boarded vehicles not accepting bikes, the journey with a transfer is kept.
+ */
+BOOST_AUTO_TEST_CASE(mc_raptor_vehicle_properties) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("l1").bike_accepted(false)("A", "8:00"_t)("B", "8:30"_t);
+        b.vj("l2")("A", "8:05"_t)("C", "8:10"_t);
+        b.vj("l3")("C", "8:15"_t)("B", "8:40"_t);
+        b.connection("C", "C", 120);
+    });
+
+    RAPTOR raptor(*b.data);
+    auto res = compute_mc(raptor, "A", "B");
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res.front().sections.size(), 1);
+
+    raptor.mc_params.criteria.push_back(make_mc_criterion("bike_accepted"));
+    res = compute_mc(raptor, "A", "B");
+    BOOST_REQUIRE_EQUAL(res.size(), 2);
+    const auto with_transfer = boost::find_if(res, [](const Journey& j) { return j.sections.size() == 2; });
+    BOOST_REQUIRE(with_transfer != res.end());
+    BOOST_CHECK_EQUAL(with_transfer->departure_dt, DateTimeUtils::set(0, "8:05"_t));
+    BOOST_CHECK_EQUAL(with_transfer->arrival_dt, DateTimeUtils::set(0, "8:40"_t));
+    BOOST_CHECK_EQUAL(with_transfer->transfer_dur, 120_s);
+    BOOST_CHECK_EQUAL(with_transfer->total_waiting_dur, 180_s);
+}
+
+/*
+ * A ---l1---> B                     arrives at 8:31
+ * A ---l2---> C, C ---l3---> B      arrives at 8:30
+ *
+ * The journey with a transfer only arrives one minute earlier: as with RAPTOR, it is dominated when
+ * the transfer penalty is greater than that.
+ */
+BOOST_AUTO_TEST_CASE(mc_raptor_transfer_penalty) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("l1")("A", "8:00"_t)("B", "8:31"_t);
+        b.vj("l2")("A", "8:00"_t)("C", "8:10"_t);
+        b.vj("l3")("C", "8:15"_t)("B", "8:30"_t);
+        b.connection("C", "C", 120);
+    });
+
+    RAPTOR raptor(*b.data);
+    raptor.mc_mode = true;
+
+    auto res = compute_mc(raptor, "A", "B", 0_s);
+    const std::vector<DateTime> expected = {DateTimeUtils::set(0, "8:30"_t), DateTimeUtils::set(0, "8:31"_t)};
+    const auto arrivals = arrivals_of(res);
+    BOOST_CHECK_EQUAL_COLLECTIONS(arrivals.begin(), arrivals.end(), expected.begin(), expected.end());
+
+    res = compute_mc(raptor, "A", "B", 2_min);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res.front().arrival_dt, DateTimeUtils::set(0, "8:31"_t));
+    BOOST_CHECK_EQUAL(res.front().sections.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(mc_raptor_unknown_criterion) {
+    BOOST_CHECK_THROW(make_mc_criterion("unknown"), std::invalid_argument);
+    BOOST_CHECK(make_mc_criterion("air_conditioned") != nullptr);
+}
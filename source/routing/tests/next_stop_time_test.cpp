@@ -2569,3 +2569,28 @@ BOOST_AUTO_TEST_CASE(freq_next_stop_time_with_distant_bounds) {
         BOOST_CHECK_EQUAL(st->stop_point->stop_area->name, spa2);
     }
 }
+
+BOOST_AUTO_TEST_CASE(warmup_loads_the_most_recently_used_keys) {
+    ed::builder b("20120614", [](ed::builder& b) { b.vj("A")("stop1", "10:00"_t)("stop2", "11:00"_t); });
+    const auto accessibilite_params = nt::AccessibiliteParams();
+    const auto load = [&](CachedNextStopTimeManager& manager, const int day) {
+        return manager.load(DateTimeUtils::set(day, "08:00"_t), nt::RTLevel::Base, accessibilite_params);
+    };
+
+    CachedNextStopTimeManager previous(*b.data->dataRaptor, 2);
+    // the caches are kept alive, the day 1 being the most recently used
+    const auto day_1 = load(previous, 1);
+    const auto day_2 = load(previous, 2);
+    const auto day_3 = load(previous, 3);
+    load(previous, 1);
+
+    CachedNextStopTimeManager manager(*b.data->dataRaptor, 2);
+    manager.warmup(previous);
+    const auto nb_cache_miss = manager.get_nb_cache_miss();
+    BOOST_CHECK_EQUAL(nb_cache_miss, 2);
+    load(manager, 3);
+    load(manager, 1);
+    BOOST_CHECK_EQUAL(manager.get_nb_cache_miss(), nb_cache_miss);
+    load(manager, 2);
+    BOOST_CHECK_EQUAL(manager.get_nb_cache_miss(), nb_cache_miss + 1);
+}
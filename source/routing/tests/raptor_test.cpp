@@ -1816,6 +1816,47 @@ BOOST_AUTO_TEST_CASE(accessible_on_first_sp) {
     BOOST_CHECK_EQUAL(res[0].items.back().arrival, time_from_string("2015-01-01 10:00:00"));
 }
 
+// The valid journey patterns are kept between the requests of a RAPTOR while its
+// filters do not change: the result must follow the filters of each request.
+BOOST_AUTO_TEST_CASE(valid_jp_and_jpp_reused_between_requests) {
+    using boost::posix_time::time_from_string;
+    using navitia::type::hasProperties;
+
+    ed::builder b("20150101", [](ed::builder& b) {
+        b.sa("A")("A1", 0, 0, false)("A2", 0, 0, true);
+        b.sa("B")("B1", 0, 0, true);
+        b.vj("1")("A1", "8:30"_t)("B1", "9:00"_t);
+        b.vj("2")("A2", "8:00"_t)("B1", "10:00"_t);
+    });
+
+    auto params = type::AccessibiliteParams();
+    params.properties.set(hasProperties::WHEELCHAIR_BOARDING, true);
+    RAPTOR raptor(*(b.data));
+    const type::PT_Data& d = *b.data->pt_data;
+    const auto compute = [&](const type::AccessibiliteParams& p, const std::vector<std::string>& forbidden) {
+        return raptor.compute(d.stop_areas_map.at("A"), d.stop_areas_map.at("B"), "8:00"_t, 0, DateTimeUtils::inf,
+                              type::RTLevel::Base, 2_min, 2_min, true, p, std::numeric_limits<uint32_t>::max(),
+                              forbidden);
+    };
+
+    for (int i = 0; i < 2; ++i) {
+        auto res = compute(type::AccessibiliteParams(), {});
+        BOOST_REQUIRE_EQUAL(res.size(), 1);
+        BOOST_CHECK_EQUAL(res[0].items.back().arrival, time_from_string("2015-01-01 09:00:00"));
+
+        res = compute(params, {});
+        BOOST_REQUIRE_EQUAL(res.size(), 1);
+        BOOST_CHECK_EQUAL(res[0].items.back().arrival, time_from_string("2015-01-01 10:00:00"));
+
+        res = compute(type::AccessibiliteParams(), {"A2"});
+        BOOST_REQUIRE_EQUAL(res.size(), 1);
+        BOOST_CHECK_EQUAL(res[0].items.back().arrival, time_from_string("2015-01-01 09:00:00"));
+
+        res = compute(params, {"A2"});
+        BOOST_CHECK_EQUAL(res.size(), 0);
+    }
+}
+
 // If the direct path duration is better than everything, no journey is returned
 //
 // Here, we have a pt journey  of 10s walk + 1 min pt + 10s walk.
@@ -3367,3 +3408,222 @@ BOOST_AUTO_TEST_CASE(test_jira1686_should_take_journey_with_minimum_walking_on_t
     BOOST_CHECK_EQUAL(res[0].items[0].stop_points[0]->uri, "A");
     BOOST_CHECK_EQUAL(res[1].items[0].stop_points[0]->uri, "B");
 }
+
+/*
+ * A -----l1----> B every 10 minutes from 8:00 to 8:20
+ * A -----l2----> B at 8:15, overtaken by the 8:20 l1 vj
+ *
+ * A profile search from 7:55 with a timeframe ending at 8:25 must find
+ * the three l1 journeys, each one computed for its own departure, starting
+ * with the latest one as rRAPTOR scans the departures backward.
+ */
+BOOST_AUTO_TEST_CASE(profile_journeys_on_timeframe) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("l1")("A", "8:00"_t)("B", "8:30"_t);
+        b.vj("l1")("A", "8:10"_t)("B", "8:40"_t);
+        b.vj("l1")("A", "8:20"_t)("B", "8:50"_t);
+        b.vj("l2")("A", "8:15"_t)("B", "9:00"_t);
+    });
+
+    RAPTOR raptor(*(b.data));
+    type::PT_Data& d = *b.data->pt_data;
+
+    routing::map_stop_point_duration departures, arrivals;
+    departures[routing::SpIdx(*d.stop_points_map["A"])] = {};
+    arrivals[routing::SpIdx(*d.stop_points_map["B"])] = {};
+
+    const auto departure_time = DateTimeUtils::set(0, "7:55"_t);
+    const auto timeframe_limit = DateTimeUtils::set(0, "8:25"_t);
+    const auto rt_level = nt::RTLevel::Base;
+    raptor.set_valid_jp_and_jpp(DateTimeUtils::date(departure_time), {}, {}, {}, rt_level);
+    const auto res = raptor.compute_profile_journeys(departures, arrivals, departure_time, timeframe_limit, rt_level,
+                                                     2_min, 2_min);
+
+    BOOST_REQUIRE_EQUAL(res.size(), 3);
+    const std::vector<std::pair<uint32_t, uint32_t>> expected = {
+        {"8:20"_t, "8:50"_t}, {"8:10"_t, "8:40"_t}, {"8:00"_t, "8:30"_t}};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        BOOST_CHECK_EQUAL(res[i].first, DateTimeUtils::set(0, expected[i].first));
+        BOOST_REQUIRE_EQUAL(res[i].second.size(), 1);
+        const auto& journey = res[i].second.front();
+        BOOST_REQUIRE_EQUAL(journey.sections.size(), 1);
+        BOOST_CHECK_EQUAL(journey.sections[0].get_in_dt, DateTimeUtils::set(0, expected[i].first));
+        BOOST_CHECK_EQUAL(journey.sections[0].get_out_dt, DateTimeUtils::set(0, expected[i].second));
+    }
+
+    // the profile must give the same journey as a classic raptor for the requested datetime
+    const auto classic = raptor.compute_all(departures, arrivals, DateTimeUtils::set(0, "8:00"_t));
+    BOOST_REQUIRE_EQUAL(classic.size(), 1);
+    BOOST_CHECK_EQUAL(classic[0].items[0].departure, "20120614T080000"_dt);
+}
+
+/*
+ * The second pass has several starting points (one per destination and per number of transfers),
+ * running it on several threads must give the same journeys as the sequential second pass.
+ */
+BOOST_AUTO_TEST_CASE(parallel_second_pass_gives_same_journeys) {
+    ed::builder b("20150101", [](ed::builder& b) {
+        b.vj("1")("A", "8:00"_t)("B", "8:30"_t)("C", "9:00"_t)("D", "9:30"_t);
+        b.vj("2")("A", "8:05"_t)("E", "8:20"_t);
+        b.vj("3")("E", "8:25"_t)("C", "8:50"_t)("F", "9:10"_t);
+        b.vj("4")("B", "8:40"_t)("F", "9:05"_t)("D", "9:20"_t);
+    });
+
+    auto& sp_map = b.get_data().pt_data->stop_points_map;
+    routing::map_stop_point_duration departures, arrivals;
+    departures[SpIdx(*sp_map["A"])] = 0_min;
+    arrivals[SpIdx(*sp_map["C"])] = 3_min;
+    arrivals[SpIdx(*sp_map["D"])] = 0_min;
+    arrivals[SpIdx(*sp_map["F"])] = 1_min;
+
+    // the same raptors are used for all the requests, their helpers and their threads are reused
+    RAPTOR sequential_raptor(b.get_data());
+    RAPTOR parallel_raptor(b.get_data());
+    auto compute = [&](RAPTOR& raptor, size_t nb_threads, size_t max_extra_second_pass) {
+        raptor.nb_snd_pass_threads = nb_threads;
+        return raptor.compute_all(departures, arrivals, DateTimeUtils::set(0, "7:50"_t), type::RTLevel::Base, 2_min,
+                                  2_min, DateTimeUtils::inf, 10, {}, {}, {}, true, boost::none, max_extra_second_pass);
+    };
+
+    // with few extra second passes allowed, the starting points dominated by the journeys of their batch must not
+    // use them up
+    for (size_t max_extra_second_pass : {0, 1, 2, 10}) {
+        const auto sequential = compute(sequential_raptor, 1, max_extra_second_pass);
+        BOOST_REQUIRE(!sequential.empty());
+        for (size_t nb_threads : {2, 4, 3}) {
+            const auto parallel = compute(parallel_raptor, nb_threads, max_extra_second_pass);
+            BOOST_REQUIRE_EQUAL(parallel.size(), sequential.size());
+            for (size_t i = 0; i < sequential.size(); ++i) {
+                BOOST_CHECK_EQUAL(parallel[i].items.size(), sequential[i].items.size());
+                BOOST_CHECK_EQUAL(parallel[i].items.front().departure, sequential[i].items.front().departure);
+                BOOST_CHECK_EQUAL(parallel[i].items.back().arrival, sequential[i].items.back().arrival);
+                BOOST_CHECK_EQUAL(parallel[i].items.back().stop_points.back()->uri,
+                                  sequential[i].items.back().stop_points.back()->uri);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(target_pruning_bounds) {
+    map_stop_point_duration destinations;
+    destinations[SpIdx(1)] = 60_s;
+    destinations[SpIdx(2)] = 120_s;
+
+    TargetPruning pruning;
+    pruning.init(destinations, 3, true, 0, boost::none);
+    BOOST_CHECK(!pruning.is_dominated(5000, 1000));
+
+    // not a destination, nothing to prune with
+    pruning.add_arrival(SpIdx(0), 500, 0);
+    BOOST_CHECK(!pruning.is_dominated(5000, 1000));
+
+    // arrival at 1060 with 160s of walking
+    pruning.add_arrival(SpIdx(1), 1000, 100);
+    BOOST_CHECK(!pruning.is_dominated(1000, 100));
+    BOOST_CHECK(pruning.is_dominated(1001, 100));
+    BOOST_CHECK(!pruning.is_dominated(1001, 99));
+
+    // the direct path arrives at 1000 with 300s of walking
+    pruning.init(destinations, 3, true, 700, 300_s);
+    BOOST_CHECK(pruning.is_dominated(950, 300));
+    BOOST_CHECK(!pruning.is_dominated(950, 200));
+    BOOST_CHECK(!pruning.is_dominated(900, 300));
+
+    // anticlockwise, departure at 940 with 160s of walking
+    pruning.init(destinations, 3, false, 5000, boost::none);
+    pruning.add_arrival(SpIdx(1), 1000, 100);
+    BOOST_CHECK(pruning.is_dominated(999, 100));
+    BOOST_CHECK(!pruning.is_dominated(1000, 100));
+
+    pruning.reset();
+    BOOST_CHECK(!pruning.enabled());
+    BOOST_CHECK(!pruning.is_dominated(0, 10000));
+}
+
+// clear() only resets the rounds of labels used by the previous search: a RAPTOR alternating
+// directions and numbers of rounds must find the journeys of a fresh one
+BOOST_AUTO_TEST_CASE(labels_reset_between_searches) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("A", "11111111", "", true)("stop1", 8000, 8050)("stop2", 8200, 8250);
+        b.vj("B", "11111111", "", true)("stop3", 9000, 9050)("stop4", 9200, 9250);
+        b.connection("stop2", "stop3", 10 * 60);
+        b.connection("stop3", "stop2", 10 * 60);
+    });
+    const type::PT_Data& d = *b.data->pt_data;
+    const auto compute = [&](RAPTOR& raptor, const std::string& from, const std::string& to, const bool clockwise) {
+        return raptor.compute(d.stop_areas_map.at(from), d.stop_areas_map.at(to), clockwise ? 7900 : 9300, 0,
+                              clockwise ? DateTimeUtils::inf : 0, type::RTLevel::Base, 2_min, 2_min, clockwise);
+    };
+
+    RAPTOR raptor(*b.data);
+    const std::vector<std::tuple<std::string, std::string, bool>> requests = {{"stop1", "stop4", true},
+                                                                              {"stop1", "stop2", false},
+                                                                              {"stop1", "stop4", false},
+                                                                              {"stop3", "stop4", true},
+                                                                              {"stop1", "stop4", true}};
+    for (const auto& request : requests) {
+        RAPTOR fresh_raptor(*b.data);
+        const auto res = compute(raptor, std::get<0>(request), std::get<1>(request), std::get<2>(request));
+        const auto expected =
+            compute(fresh_raptor, std::get<0>(request), std::get<1>(request), std::get<2>(request));
+        BOOST_REQUIRE(!expected.empty());
+        BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+        for (size_t i = 0; i < res.size(); ++i) {
+            BOOST_REQUIRE_EQUAL(res[i].items.size(), expected[i].items.size());
+            BOOST_CHECK_EQUAL(res[i].items.front().departure, expected[i].items.front().departure);
+            BOOST_CHECK_EQUAL(res[i].items.back().arrival, expected[i].items.back().arrival);
+        }
+    }
+}
+
+/*
+ * A ---l1---> B ---l1---> C
+ * A ---l2---> D, D ---l3---> C
+ *
+ * A one-to-many raptor (from A, or to C if anticlockwise) must give, for each other side, the
+ * journeys of a raptor computed for this pair only.
+ */
+BOOST_AUTO_TEST_CASE(one_to_many_journeys_as_separate_requests) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("l1")("A", "8:00"_t)("B", "8:20"_t)("C", "9:00"_t);
+        b.vj("l2")("A", "8:05"_t)("D", "8:15"_t);
+        b.vj("l3")("D", "8:20"_t)("C", "8:40"_t);
+        b.connection("D", "D", 120);
+    });
+    type::PT_Data& d = *b.data->pt_data;
+    const auto rt_level = nt::RTLevel::Base;
+    const auto sp_map = [&](const std::string& uri, const navitia::time_duration& dur) {
+        map_stop_point_duration res;
+        res[SpIdx(*d.stop_points_map[uri])] = dur;
+        return res;
+    };
+
+    for (const bool clockwise : {true, false}) {
+        // from A to B, C and D, and to C from A, B and D
+        const auto shared = clockwise ? sp_map("A", 0_s) : sp_map("C", 0_s);
+        const std::vector<map_stop_point_duration> others = {
+            sp_map("B", 0_s), clockwise ? sp_map("C", 60_s) : sp_map("A", 60_s), sp_map("D", 0_s)};
+        RAPTOR raptor(*b.data);
+        const auto datetime = DateTimeUtils::set(0, clockwise ? "7:55"_t : "9:30"_t);
+        const auto bound = clockwise ? DateTimeUtils::inf : DateTimeUtils::min;
+        raptor.set_valid_jp_and_jpp(DateTimeUtils::date(datetime), {}, {}, {}, rt_level);
+        const auto res = raptor.compute_one_to_many_journeys(shared, others, datetime, rt_level, 2_min, 2_min, bound,
+                                                             10, {}, clockwise, {boost::none, 2_h, boost::none});
+        BOOST_REQUIRE_EQUAL(res.size(), others.size());
+
+        for (size_t i = 0; i < others.size(); ++i) {
+            const auto& departures = clockwise ? shared : others[i];
+            const auto& destinations = clockwise ? others[i] : shared;
+            const auto direct_path_dur = i == 1 ? boost::make_optional(2_h) : boost::none;
+            RAPTOR fresh_raptor(*b.data);
+            fresh_raptor.set_valid_jp_and_jpp(DateTimeUtils::date(datetime), {}, {}, {}, rt_level);
+            const auto expected = fresh_raptor.compute_all_journeys(departures, destinations, datetime, rt_level,
+                                                                    2_min, 2_min, bound, 10, {}, clockwise,
+                                                                    direct_path_dur);
+            BOOST_REQUIRE(!expected.empty());
+            const JourneySet res_set(res[i].begin(), res[i].end());
+            const JourneySet expected_set(expected.begin(), expected.end());
+            BOOST_CHECK(res_set == expected_set);
+        }
+    }
+}
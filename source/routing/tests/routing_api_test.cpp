@@ -1811,7 +1811,7 @@ BOOST_AUTO_TEST_CASE(use_crow_fly) {
     BOOST_CHECK(nr::use_crow_fly(ep, sp2, empty_sn_path, data));
     BOOST_CHECK(!nr::use_crow_fly(ep, sp2, filled_sn_path, data));
 
-    admin->main_stop_areas.push_back(&sa2);
+    data.pt_data->main_stop_areas_by_admin[admin->idx].push_back(&sa2);
     BOOST_CHECK(nr::use_crow_fly(ep, sp2, empty_sn_path, data));
     BOOST_CHECK(nr::use_crow_fly(ep, sp2, filled_sn_path, data));
 }
@@ -4020,3 +4020,40 @@ BOOST_AUTO_TEST_CASE(backtracking_journey_stay_in_not_on_first_day) {
         BOOST_CHECK_EQUAL(j.sections.front().get_out_dt, "24:01:00"_t);
     }
 }
+
+/*
+ * The pairs of a batch without stop point on a side get the same errors as make_response,
+ * without preventing the other pairs of the batch from being computed
+ */
+BOOST_AUTO_TEST_CASE(pt_batch_without_origin_or_destination) {
+    ed::builder b("20150614", [](ed::builder& b) { b.vj("l1")("A", "8:25"_t)("B", "8:35"_t); });
+    nr::RAPTOR raptor(*b.data);
+
+    const navitia::type::EntryPoints a{{navitia::type::Type_e::StopPoint, "A"}};
+    const navitia::type::EntryPoints b_sp{{navitia::type::Type_e::StopPoint, "B"}};
+    const std::vector<nr::PtBatchItem> items = {{a, b_sp, boost::none},
+                                                {{}, b_sp, boost::none},
+                                                {a, {}, boost::none},
+                                                {{}, {}, boost::none}};
+
+    auto* data_ptr = b.data.get();
+    navitia::PbCreator pb_creator(data_ptr, boost::gregorian::not_a_date_time, null_time_period);
+    const auto responses = nr::make_pt_batch_response(pb_creator, raptor, items, "20150615T082000"_pts, true, {}, {},
+                                                      {}, nt::RTLevel::Base, 2_min, 2_min);
+    BOOST_REQUIRE_EQUAL(responses.size(), 4);
+
+    BOOST_CHECK_EQUAL(responses[0].response_type(), pbnavitia::ITINERARY_FOUND);
+    BOOST_CHECK_EQUAL(responses[0].journeys_size(), 1);
+
+    BOOST_CHECK_EQUAL(responses[1].response_type(), pbnavitia::NO_ORIGIN_POINT);
+    BOOST_CHECK_EQUAL(responses[1].error().id(), pbnavitia::Error::no_origin);
+    BOOST_CHECK_EQUAL(responses[1].journeys_size(), 0);
+
+    BOOST_CHECK_EQUAL(responses[2].response_type(), pbnavitia::NO_DESTINATION_POINT);
+    BOOST_CHECK_EQUAL(responses[2].error().id(), pbnavitia::Error::no_destination);
+    BOOST_CHECK_EQUAL(responses[2].journeys_size(), 0);
+
+    BOOST_CHECK_EQUAL(responses[3].response_type(), pbnavitia::NO_ORIGIN_NOR_DESTINATION_POINT);
+    BOOST_CHECK_EQUAL(responses[3].error().id(), pbnavitia::Error::no_origin_nor_destination);
+    BOOST_CHECK_EQUAL(responses[3].journeys_size(), 0);
+}
@@ -556,7 +556,7 @@ struct routing_api_data {
         b.data->pt_data->codes.add(sa, "UIC8", "80142281");
 
         // Add a main stop area to our admin
-        admin->main_stop_areas.push_back(b.data->pt_data->stop_areas_map["stopC"]);
+        b.data->pt_data->main_stop_areas_by_admin[admin->idx].push_back(b.data->pt_data->stop_areas_map["stopC"]);
 
         b.data->build_proximity_list();
         b.data->meta->production_date = boost::gregorian::date_period("20120614"_d, 365_days);
@@ -0,0 +1,155 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_travel_time_matrix
+#include <boost/test/unit_test.hpp>
+#include "routing/travel_time_matrix.h"
+#include "routing/raptor.h"
+#include "ed/build_helper.h"
+#include "tests/utils_test.h"
+#include "utils/logger.h"
+
+struct logger_initialized {
+    logger_initialized() {
+        navitia::init_logger();
+        auto raptor_logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("raptor"));
+        raptor_logger.setLogLevel(log4cplus::FATAL_LOG_LEVEL);
+    }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+using namespace navitia;
+using namespace routing;
+
+/*
+ * A ---l1---> B ---l1---> C   8:00, 8:20, 8:50
+ *             B ---l2---> C   8:30, 8:40
+ */
+struct matrix_fixture {
+    ed::builder b;
+    std::vector<map_stop_point_duration> origins;
+    std::vector<const type::StopArea*> destinations;
+
+    matrix_fixture()
+        : b("20120614", [](ed::builder& b) {
+              b.vj("l1")("A", "8:00"_t)("B", "8:20"_t)("C", "8:50"_t);
+              b.vj("l2")("B", "8:30"_t)("C", "8:40"_t);
+              b.connection("B", "B", 60);
+          }) {
+        const auto& d = *b.data->pt_data;
+        origins.resize(2);
+        origins[0][SpIdx(*d.stop_points_map.at("A"))] = 0_s;
+        origins[1][SpIdx(*d.stop_points_map.at("B"))] = 5_min;
+        for (const auto* uri : {"A", "B", "C"}) {
+            destinations.push_back(d.stop_areas_map.at(uri));
+        }
+    }
+
+    TravelTimeMatrix::Params params(const uint32_t window_duration = 0) const {
+        TravelTimeMatrix::Params params;
+        params.departure_datetime = DateTimeUtils::set(0, "7:55"_t);
+        params.window_duration = window_duration;
+        params.window_step = 5 * 60;
+        return params;
+    }
+};
+
+static void check_cell(const TravelTimeMatrix::Cell& cell, const uint32_t duration, const uint16_t nb_transfers) {
+    BOOST_CHECK_EQUAL(cell.duration, duration);
+    if (duration != TravelTimeMatrix::unreachable) {
+        BOOST_CHECK_EQUAL(cell.nb_transfers, nb_transfers);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(travel_time_matrix_one_departure, matrix_fixture) {
+    TravelTimeMatrix matrix(*b.data);
+    const auto rows = matrix.compute(origins, destinations, params());
+
+    BOOST_REQUIRE_EQUAL(rows.size(), 2);
+    BOOST_REQUIRE_EQUAL(rows[0].size(), 3);
+    check_cell(rows[0][0], 0, 0);
+    check_cell(rows[0][1], 25 * 60, 0);
+    // the transfer to l2 arrives before l1
+    check_cell(rows[0][2], 45 * 60, 1);
+
+    check_cell(rows[1][0], TravelTimeMatrix::unreachable, 0);
+    check_cell(rows[1][1], 5 * 60, 0);
+    check_cell(rows[1][2], 45 * 60, 0);
+}
+
+// the best duration over the departures of the window is kept, and the threads do not change it
+BOOST_FIXTURE_TEST_CASE(travel_time_matrix_window_and_threads, matrix_fixture) {
+    TravelTimeMatrix matrix(*b.data, 2);
+    std::vector<size_t> streamed;
+    std::string binary;
+    std::vector<TravelTimeMatrix::Row> rows(origins.size());
+    matrix.compute(origins, destinations, params(30 * 60), [&](size_t origin_idx, const TravelTimeMatrix::Row& row) {
+        streamed.push_back(origin_idx);
+        rows[origin_idx] = row;
+        append_travel_time_row(binary, origin_idx, row);
+    });
+
+    BOOST_CHECK_EQUAL(streamed.size(), 2);
+    check_cell(rows[0][1], 20 * 60, 0);
+    check_cell(rows[0][2], 40 * 60, 1);
+    // from B at 8:25 (with 5 minutes to reach it), l2 is boarded at 8:30
+    check_cell(rows[1][2], 15 * 60, 0);
+
+    BOOST_REQUIRE_EQUAL(binary.size(), 2 * (8 + 5 * destinations.size()));
+    BOOST_CHECK_EQUAL(binary[4], char(destinations.size()));
+}
+
+/*
+ * A ---l1---> B   8:00, 8:20
+ *             B ~~3 min~~> D
+ *
+ * D is only reached by the connection from B, after alighting from l1
+ */
+BOOST_AUTO_TEST_CASE(travel_time_matrix_destination_reached_by_a_connection) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("l1")("A", "8:00"_t)("B", "8:20"_t);
+        b.vj("l2")("D", "9:00"_t)("E", "9:10"_t);
+        b.connection("B", "D", 3 * 60);
+    });
+    const auto& d = *b.data->pt_data;
+    std::vector<map_stop_point_duration> origins(1);
+    origins[0][SpIdx(*d.stop_points_map.at("A"))] = 0_s;
+    const std::vector<const type::StopArea*> destinations = {d.stop_areas_map.at("D")};
+
+    TravelTimeMatrix::Params params;
+    params.departure_datetime = DateTimeUtils::set(0, "7:55"_t);
+    TravelTimeMatrix matrix(*b.data);
+    const auto rows = matrix.compute(origins, destinations, params);
+
+    BOOST_REQUIRE_EQUAL(rows.size(), 1);
+    BOOST_REQUIRE_EQUAL(rows[0].size(), 1);
+    check_cell(rows[0][0], 28 * 60, 0);
+}
@@ -0,0 +1,185 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/travel_time_matrix.h"
+
+#include "routing/raptor.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+
+#include <exception>
+#include <future>
+#include <mutex>
+
+namespace navitia {
+namespace routing {
+
+constexpr uint32_t TravelTimeMatrix::unreachable;
+
+TravelTimeMatrix::TravelTimeMatrix(const type::Data& data, size_t nb_threads)
+    : data(data), workers(std::max(nb_threads, size_t(1)) - 1) {
+    for (size_t i = 0; i < std::max(nb_threads, size_t(1)); ++i) {
+        raptors.push_back(std::make_unique<RAPTOR>(data));
+    }
+}
+
+TravelTimeMatrix::~TravelTimeMatrix() = default;
+
+static bool better(const TravelTimeMatrix::Cell& lhs, const TravelTimeMatrix::Cell& rhs) {
+    return lhs.duration < rhs.duration || (lhs.duration == rhs.duration && lhs.nb_transfers < rhs.nb_transfers);
+}
+
+// run the first passes of the departures of the window from origin, keeping the best arrival at
+// each destination
+static void compute_row(RAPTOR& raptor,
+                        const map_stop_point_duration& origin,
+                        const std::vector<std::vector<SpIdx>>& destination_sps,
+                        const TravelTimeMatrix::Params& params,
+                        TravelTimeMatrix::Row& row) {
+    const DateTime last_departure = params.departure_datetime + params.window_duration;
+    for (DateTime departure = params.departure_datetime; departure <= last_departure;
+         departure += std::max(params.window_step, 1u)) {
+        const DateTime bound = limit_bound(true, departure, departure + params.max_duration);
+        raptor.first_raptor_loop(origin, departure, params.rt_level, bound, params.max_transfers,
+                                 params.accessibilite_params, true);
+
+        for (size_t i = 0; i < destination_sps.size(); ++i) {
+            auto& cell = row[i];
+            for (const auto sp_idx : destination_sps[i]) {
+                const auto it = origin.find(sp_idx);
+                if (it != origin.end()) {
+                    // reached by the fallback of the origin
+                    TravelTimeMatrix::Cell candidate;
+                    candidate.duration = it->second.total_seconds();
+                    if (better(candidate, cell)) {
+                        cell = candidate;
+                    }
+                    continue;
+                }
+                // the stop point is reached either by a vehicle or by a connection after alighting at
+                // another stop point of the round
+                for (unsigned count = 1; count <= raptor.count; ++count) {
+                    const auto& label = raptor.labels[count][sp_idx];
+                    const DateTime arrival = std::min(label.dt_pt, label.dt_transfer);
+                    if (!is_dt_initialized(arrival) || arrival >= bound) {
+                        continue;
+                    }
+                    TravelTimeMatrix::Cell candidate;
+                    candidate.duration = arrival - departure;
+                    candidate.nb_transfers = static_cast<uint16_t>(count - 1);
+                    if (better(candidate, cell)) {
+                        cell = candidate;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void TravelTimeMatrix::compute(const std::vector<map_stop_point_duration>& origins,
+                               const std::vector<const type::StopArea*>& destinations,
+                               const Params& params,
+                               const RowCallback& row_callback) {
+    std::vector<std::vector<SpIdx>> destination_sps;
+    destination_sps.reserve(destinations.size());
+    for (const auto* stop_area : destinations) {
+        destination_sps.emplace_back();
+        for (const auto* sp : stop_area->stop_point_list) {
+            destination_sps.back().emplace_back(*sp);
+        }
+    }
+
+    // the thread i computes the rows i, i + nb_threads, i + 2 * nb_threads...
+    const size_t nb_threads = std::min(raptors.size(), origins.size());
+    std::mutex callback_mutex;
+    auto compute_rows = [&](size_t thread_idx) {
+        auto& raptor = *raptors[thread_idx];
+        raptor.set_valid_jp_and_jpp(DateTimeUtils::date(params.departure_datetime), params.accessibilite_params,
+                                    params.forbidden, params.allowed, params.rt_level);
+        Row row;
+        for (size_t i = thread_idx; i < origins.size(); i += nb_threads) {
+            row.assign(destinations.size(), Cell());
+            compute_row(raptor, origins[i], destination_sps, params, row);
+            std::lock_guard<std::mutex> lock(callback_mutex);
+            row_callback(i, row);
+        }
+    };
+    std::vector<std::future<void>> futures;
+    for (size_t thread_idx = 1; thread_idx < nb_threads; ++thread_idx) {
+        futures.push_back(workers.push([&compute_rows, thread_idx]() { compute_rows(thread_idx); }));
+    }
+    std::exception_ptr error;
+    if (nb_threads > 0) {
+        try {
+            compute_rows(0);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    // the rows use the locals of this frame, they must all be over before anything is rethrown
+    for (const auto& future : futures) {
+        future.wait();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+std::vector<TravelTimeMatrix::Row> TravelTimeMatrix::compute(const std::vector<map_stop_point_duration>& origins,
+                                                             const std::vector<const type::StopArea*>& destinations,
+                                                             const Params& params) {
+    std::vector<Row> rows(origins.size());
+    compute(origins, destinations, params, [&](size_t origin_idx, const Row& row) { rows[origin_idx] = row; });
+    return rows;
+}
+
+static void append_uint32(std::string& out, const uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void append_travel_time_row(std::string& out, const uint32_t origin_idx, const TravelTimeMatrix::Row& row) {
+    out.reserve(out.size() + 8 + 5 * row.size());
+    append_uint32(out, origin_idx);
+    append_uint32(out, static_cast<uint32_t>(row.size()));
+    for (const auto& cell : row) {
+        append_uint32(out, cell.duration);
+    }
+    for (const auto& cell : row) {
+        out.push_back(static_cast<char>(std::min<uint16_t>(cell.nb_transfers, 0xFF)));
+    }
+}
+
+}  // namespace routing
+}  // namespace navitia
@@ -0,0 +1,118 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "routing/raptor_utils.h"
+#include "type/type_interfaces.h"
+#include "type/worker_pool.h"
+#include "type/accessibility_params.h"
+#include "type/rt_level.h"
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace navitia {
+
+namespace type {
+class Data;
+struct StopArea;
+}  // namespace type
+
+namespace routing {
+
+struct RAPTOR;
+
+/**
+ * Travel times from several origins to several stop areas, for accessibility matrices
+ *
+ * For each origin, a one-to-all raptor (the first pass, as RAPTOR::isochrone) is run for each
+ * departure of the window, and the arrival at a stop area is the earliest arrival at one of its
+ * stop points. The rows of the origins are computed on several threads, each one with its own RAPTOR.
+ * The threads and the RAPTORs are kept from one computation to the other.
+ */
+struct TravelTimeMatrix {
+    static constexpr uint32_t unreachable = std::numeric_limits<uint32_t>::max();
+
+    struct Cell {
+        uint32_t duration = unreachable;  // best duration over the departures of the window, in seconds
+        uint16_t nb_transfers = 0;        // of the journey giving this duration
+    };
+    using Row = std::vector<Cell>;
+
+    struct Params {
+        DateTime departure_datetime = 0;
+        // the departures are departure_datetime, departure_datetime + window_step, ... up to
+        // departure_datetime + window_duration
+        uint32_t window_duration = 0;
+        uint32_t window_step = 60;
+        uint32_t max_duration = DateTimeUtils::SECONDS_PER_DAY;
+        uint32_t max_transfers = 10;
+        type::AccessibiliteParams accessibilite_params;
+        std::vector<std::string> forbidden;
+        std::vector<std::string> allowed;
+        type::RTLevel rt_level = type::RTLevel::Base;
+    };
+
+    /// called with the index of an origin and its row, as soon as it is computed
+    using RowCallback = std::function<void(size_t, const Row&)>;
+
+    TravelTimeMatrix(const type::Data& data, size_t nb_threads = 1);
+    ~TravelTimeMatrix();
+
+    /// The rows are given to row_callback in no particular order, one call at a time
+    void compute(const std::vector<map_stop_point_duration>& origins,
+                 const std::vector<const type::StopArea*>& destinations,
+                 const Params& params,
+                 const RowCallback& row_callback);
+
+    /// Return the whole matrix, the rows being the origins and the columns the destinations
+    std::vector<Row> compute(const std::vector<map_stop_point_duration>& origins,
+                             const std::vector<const type::StopArea*>& destinations,
+                             const Params& params);
+
+    const type::Data& data;
+    std::vector<std::unique_ptr<RAPTOR>> raptors;
+    // run the rows of the RAPTORs but the first one, that is used by the calling thread
+    WorkerPool workers;
+};
+
+/**
+ * Append the row of an origin to `out` in a compact binary form, to be streamed:
+ * the origin index and the number of cells (uint32), the durations (uint32, unreachable if no
+ * journey), then the numbers of transfers (uint8, saturated), all little endian.
+ */
+void append_travel_time_row(std::string& out, const uint32_t origin_idx, const TravelTimeMatrix::Row& row);
+
+}  // namespace routing
+}  // namespace navitia
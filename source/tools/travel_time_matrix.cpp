@@ -0,0 +1,154 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/travel_time_matrix.h"
+#include "type/data.h"
+#include "type/datetime.h"
+#include "type/meta_data.h"
+#include "type/pt_data.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+#include "utils/init.h"  // init_app()
+#include "utils/timer.h"
+
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <thread>
+
+using namespace navitia;
+
+namespace po = boost::program_options;
+
+// the stop areas whose uris are given one by line in the file, all of them if the file name is empty
+static std::vector<const type::StopArea*> read_stop_areas(const type::Data& data, const std::string& file_name) {
+    std::vector<const type::StopArea*> stop_areas;
+    if (file_name.empty()) {
+        for (const auto* stop_area : data.pt_data->stop_areas) {
+            stop_areas.push_back(stop_area);
+        }
+        return stop_areas;
+    }
+    std::ifstream file(file_name);
+    if (!file) {
+        throw std::runtime_error("unable to open " + file_name);
+    }
+    std::string uri;
+    while (std::getline(file, uri)) {
+        if (uri.empty()) {
+            continue;
+        }
+        const auto it = data.pt_data->stop_areas_map.find(uri);
+        if (it == data.pt_data->stop_areas_map.end()) {
+            throw std::runtime_error("unknown stop area " + uri);
+        }
+        stop_areas.push_back(it->second);
+    }
+    return stop_areas;
+}
+
+int main(int argc, char** argv) {
+    navitia::init_app();
+    po::options_description desc("options of travel_time_matrix");
+    std::string file, origins_file, destinations_file, departure, output;
+    routing::TravelTimeMatrix::Params params;
+    size_t nb_threads;
+
+    // clang-format off
+    desc.add_options()
+            ("help", "Show this message")
+            ("file,f", po::value<std::string>(&file)->default_value("data.nav.lz4"),
+                     "Path to data.nav.lz4")
+            ("origins", po::value<std::string>(&origins_file)->default_value(""),
+                     "File with the uri of an origin stop area by line (all the stop areas if empty)")
+            ("destinations", po::value<std::string>(&destinations_file)->default_value(""),
+                     "File with the uri of a destination stop area by line (all the stop areas if empty)")
+            ("departure,d", po::value<std::string>(&departure)->required(),
+                     "First departure of the window, as 20220614T080000")
+            ("window", po::value<uint32_t>(&params.window_duration)->default_value(0),
+                     "Duration of the departure window in seconds")
+            ("step", po::value<uint32_t>(&params.window_step)->default_value(60),
+                     "Seconds between two departures of the window")
+            ("max_duration", po::value<uint32_t>(&params.max_duration)->default_value(3 * 3600),
+                     "Maximum duration of a journey in seconds")
+            ("max_transfers", po::value<uint32_t>(&params.max_transfers)->default_value(10),
+                     "Maximum number of transfers of a journey")
+            ("threads,t", po::value<size_t>(&nb_threads)->default_value(std::thread::hardware_concurrency()),
+                     "Number of threads computing the rows")
+            ("output,o", po::value<std::string>(&output)->default_value("travel_time_matrix.bin"),
+                     "Output file, the rows as written by append_travel_time_row, in no particular order");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+
+    if (vm.count("help")) {
+        std::cout << "compute the travel times from stop areas to stop areas, as an accessibility matrix"
+                  << std::endl;
+        std::cout << desc << std::endl;
+        return 0;
+    }
+    po::notify(vm);
+
+    type::Data data;
+    {
+        Timer t("loading " + file);
+        data.load_nav(file);
+        data.build_raptor();
+    }
+    params.departure_datetime = to_datetime(boost::posix_time::from_iso_string(departure), data);
+
+    const auto origin_stop_areas = read_stop_areas(data, origins_file);
+    const auto destinations = read_stop_areas(data, destinations_file);
+    std::vector<routing::map_stop_point_duration> origins;
+    for (const auto* stop_area : origin_stop_areas) {
+        origins.emplace_back();
+        for (const auto* stop_point : stop_area->stop_point_list) {
+            origins.back()[routing::SpIdx(*stop_point)] = {};
+        }
+    }
+
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    {
+        Timer t("computing " + std::to_string(origins.size()) + " x " + std::to_string(destinations.size())
+                + " travel times");
+        routing::TravelTimeMatrix matrix(data, nb_threads);
+        std::string buffer;
+        matrix.compute(origins, destinations, params,
+                       [&](size_t origin_idx, const routing::TravelTimeMatrix::Row& row) {
+                           // the rows are streamed to the file as soon as they are computed
+                           buffer.clear();
+                           routing::append_travel_time_row(buffer, uint32_t(origin_idx), row);
+                           out.write(buffer.data(), buffer.size());
+                       });
+    }
+    return 0;
+}
@@ -57,14 +57,19 @@ www.navitia.io
 #include <boost/container/container_fwd.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 #include <boost/serialization/variant.hpp>
 #include <eos_portable_archive/portable_iarchive.hpp>
 #include <eos_portable_archive/portable_oarchive.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <thread>
 #include <regex>
 
@@ -73,7 +78,7 @@ namespace pt = boost::posix_time;
 namespace navitia {
 namespace type {
 
-const unsigned int Data::data_version = 15;  //< *INCREMENT* every time serialized data are modified
+const unsigned int Data::data_version = 17;  //< *INCREMENT* every time serialized data are modified
 
 Data::Data(size_t data_identifier)
     : _last_rt_data_loaded(boost::posix_time::not_a_date_time),
@@ -97,7 +102,9 @@ Data::~Data() = default;
 
 template <class Archive>
 void Data::save(Archive& ar, const unsigned int /*unused*/) const {
-    ar& pt_data& geo_ref& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq&
+    // geo_ref is shared, but serialized like the other unique pointers
+    const navitia::georef::GeoRef* geo_ref_ptr = geo_ref.get();
+    ar& pt_data& geo_ref_ptr& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq&
         is_realtime_loaded;
 }
 template <class Archive>
@@ -110,17 +117,22 @@ void Data::load(Archive& ar, const unsigned int version) {
             % version % v;
         throw navitia::data::wrong_version(msg.str());
     }
-    ar& pt_data& geo_ref& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq&
+    navitia::georef::GeoRef* geo_ref_ptr = nullptr;
+    ar& pt_data& geo_ref_ptr& meta& fare& last_load_at& loaded& last_load_succeeded& is_connected_to_rabbitmq&
         is_realtime_loaded;
+    geo_ref.reset(geo_ref_ptr);
 }
 SPLIT_SERIALIZABLE(Data)
 
 /**
  * @brief Load data (in nav.lz4).
- * 1. Uncompress lz4 file
- * 2. Read .nav
+ * 1. Map the lz4 file in memory
+ * 2. Uncompress it and read .nav
  * 3. Load in type::Data structure
  *
+ * The file is mapped read-only rather than read through an ifstream: the decompressor reads
+ * the pages directly, which saves one buffer copy of the compressed data while loading.
+ *
  * @param filename Lz4 data File name (file.nav.lz4)
  */
 void Data::load_nav(const std::string& filename) {
@@ -134,9 +146,9 @@ void Data::load_nav(const std::string& filename) {
     }
 
     try {
-        std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
-        ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        this->load(ifs);
+        boost::iostreams::mapped_file_source file(filename);
+        this->load(file.data(), file.size());
+        geo_ref->build_search_graph();
         last_load_at = pt::microsec_clock::universal_time();
         last_load_succeeded = true;
         LOG4CPLUS_INFO(logger, boost::format("stopTimes : %d nb foot path : %d Nombre de stop points : %d")
@@ -152,10 +164,63 @@ void Data::load_nav(const std::string& filename) {
     LOG4CPLUS_DEBUG(logger, "Finished to load nav");
 }
 
+// The chunks of the chunked .nav.lz4 are compressed and decompressed by all the cores
+static size_t lz4_nb_threads() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+namespace {
+// Source giving back the first bytes of the file, already read from the stream, before the rest of the stream
+struct PrefixedSource {
+    using char_type = char;
+    using category = boost::iostreams::source_tag;
+
+    std::string prefix;
+    std::istream* stream;
+
+    std::streamsize read(char* dest, std::streamsize size) {
+        const auto nb_prefix = std::min<std::streamsize>(size, prefix.size());
+        std::copy_n(prefix.data(), nb_prefix, dest);
+        prefix.erase(0, nb_prefix);
+        stream->read(dest + nb_prefix, size - nb_prefix);
+        const auto read_size = nb_prefix + stream->gcount();
+        return read_size == 0 ? -1 : read_size;
+    }
+};
+}  // namespace
+
 void Data::load(std::istream& ifs) {
+    // the format is told apart by the first bytes, read without seeking
+    char first[4];
+    ifs.read(first, sizeof(first));
+    const std::string prefix(first, ifs.gcount());
     boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-    in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
-    in.push(ifs);
+    if (prefix.size() == sizeof(first) && lz4_chunked::get_uint(first, 4) == lz4_chunked::magic) {
+        // the index of the chunked format is at the end of the file
+        ifs.clear();
+        if (!ifs.seekg(-std::streamoff(prefix.size()), std::ios::cur) || !lz4_chunked::is_chunked(ifs)) {
+            throw navitia::data::data_loading_error(
+                "the chunked lz4 format can only be read from a seekable stream holding the whole file");
+        }
+        in.push(LZ4ParallelSource(ifs, lz4_nb_threads()), 8192 * 500);
+    } else {
+        // files written before the chunked format
+        in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
+        in.push(PrefixedSource{prefix, &ifs});
+    }
+    eos::portable_iarchive ia(in);
+    ia >> *this;
+}
+
+void Data::load(const char* buffer, size_t size) {
+    boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+    if (lz4_chunked::is_chunked(buffer, size)) {
+        in.push(LZ4ParallelSource(buffer, size, lz4_nb_threads()), 8192 * 500);
+    } else {
+        // files written before the chunked format
+        in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
+        in.push(boost::iostreams::array_source(buffer, size));
+    }
     eos::portable_iarchive ia(in);
     ia >> *this;
 }
@@ -209,6 +274,30 @@ void Data::build_raptor(size_t cache_size) {
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     LOG4CPLUS_DEBUG(logger, "Start to build data Raptor");
     dataRaptor->load(*this->pt_data, cache_size);
+    this->pt_data->rt_modified_routes.clear();
+    LOG4CPLUS_DEBUG(logger, "Finished to build data Raptor");
+}
+
+/**
+ * @brief Build Data Raptor reusing the one of previous
+ *
+ * The data must have been cloned from previous, and then modified by realtime.
+ * Only the journey patterns of the routes modified since (see PT_Data::rt_modified_routes) are rebuilt.
+ *
+ * @param previous Data from which this one has been cloned
+ * @param cache_size Selected LRU size to optimize cache miss
+ */
+void Data::build_raptor(const Data& previous, size_t cache_size) {
+    log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
+    if (previous.pt_data->stop_points.size() != this->pt_data->stop_points.size()) {
+        LOG4CPLUS_INFO(logger, "stop points have changed, data Raptor is fully rebuilt");
+        build_raptor(cache_size);
+        return;
+    }
+    LOG4CPLUS_DEBUG(logger, "Start to build data Raptor for " << this->pt_data->rt_modified_routes.size()
+                                                              << " modified routes");
+    dataRaptor->load(*this->pt_data, *previous.dataRaptor, this->pt_data->rt_modified_routes, cache_size);
+    this->pt_data->rt_modified_routes.clear();
     LOG4CPLUS_DEBUG(logger, "Finished to build data Raptor");
 }
 
@@ -257,10 +346,14 @@ void Data::save(const std::string& filename) const {
 
 void Data::save(std::ostream& ofs) const {
     boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
-    out.push(LZ4Compressor(2048 * 500), 1024 * 500, 1024 * 500);
+    out.push(LZ4ParallelCompressor(lz4_nb_threads()), 1024 * 500, 1024 * 500);
     out.push(ofs);
-    eos::portable_oarchive oa(out);
-    oa << *this;
+    {
+        eos::portable_oarchive oa(out);
+        oa << *this;
+    }
+    // closes the compressor, that writes the last chunks and the index
+    out.pop();
 }
 
 void Data::build_uri() {
@@ -275,7 +368,12 @@ void Data::build_uri() {
 void Data::build_proximity_list() {
     this->pt_data->build_proximity_list();
     this->geo_ref->build_proximity_list();
-    this->geo_ref->project_stop_points_and_access_points(this->pt_data->stop_points);
+    this->geo_ref->project_stop_points_and_access_points(this->pt_data->stop_points,
+                                                         std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+void Data::build_landmarks(const size_t nb_landmarks) {
+    this->geo_ref->build_landmarks(nb_landmarks);
 }
 
 void Data::build_administrative_regions() {
@@ -327,7 +425,7 @@ void Data::build_administrative_regions() {
     for (const auto* sa : pt_data->stop_areas) {
         for (auto admin : sa->admin_list) {
             if (!admin->from_original_dataset) {
-                admin->main_stop_areas.push_back(sa);
+                pt_data->main_stop_areas_by_admin[admin->idx].push_back(sa);
             }
         }
     }
@@ -335,12 +433,16 @@ void Data::build_administrative_regions() {
 
 void Data::build_autocomplete() {
     geo_ref->build_autocomplete_list();
-    build_autocomplete_partial();
+    pt_data->build_autocomplete(*geo_ref);
+    pt_data->compute_score_autocomplete(*geo_ref);
 }
 
+// Only rebuild the public transport autocomplete, the scores of the admins, ways and pois
+// only depend on the stop points, that are not modified by the realtime. The street network
+// may be shared with other Data, so it must not be modified here.
 void Data::build_autocomplete_partial() {
     pt_data->build_autocomplete(*geo_ref);
-    pt_data->compute_score_autocomplete(*geo_ref);
+    pt_data->compute_pt_score_autocomplete(*geo_ref);
 }
 
 ValidityPattern* Data::get_similar_validity_pattern(ValidityPattern* vp) const {
@@ -481,7 +583,7 @@ void Data::aggregate_odt() {
     // we first store the stops in a set not to have duplicates
     for (const auto& p : odt_stops_by_admin) {
         for (const auto& sp : p.second) {
-            p.first->odt_stop_points.push_back(sp);
+            pt_data->odt_stop_points_by_admin[p.first->idx].push_back(sp);
         }
     }
 }
@@ -881,9 +983,79 @@ Type_e Data::get_type_of_id(const std::string& id) const {
 // stream the source object in a binary_oarchive, and then stream it
 // in our object.  To avoid having the whole binary_oarchive in
 // memory, we construct a pipe between 2 threads.
+//
+// The street network is by far the biggest part of the Data and is
+// never modified by the realtime, so it is not cloned: the clone shares
+// it with `from` and only the public transport referential is streamed.
+// The admins and ways pointed by the public transport objects are thus
+// streamed too, we relink them to the shared street network afterward.
 void Data::clone_from(const Data& from) {
     CloneHelper cloner;
-    cloner(from, *this);
+    cloner(*from.pt_data, *pt_data);
+    cloner(*from.meta, *meta);
+    cloner(*from.fare, *fare);
+    geo_ref = from.geo_ref;
+    last_load_at = from.last_load_at;
+    loaded = from.loaded.load();
+    last_load_succeeded = from.last_load_succeeded;
+    is_connected_to_rabbitmq = from.is_connected_to_rabbitmq.load();
+    is_realtime_loaded = from.is_realtime_loaded.load();
+    relink_georef();
+}
+
+template <typename T>
+static T* find_shared_georef_object(const std::vector<T*>& objects, const T& copy) {
+    if (copy.idx < objects.size() && objects[copy.idx]->uri == copy.uri) {
+        return objects[copy.idx];
+    }
+    // the idx of the objects made by hand (in the tests for example) may not be their position
+    const auto it = boost::find_if(objects, [&](const T* obj) { return obj->uri == copy.uri; });
+    if (it == objects.end()) {
+        throw std::runtime_error("cloned data: impossible to find " + copy.uri + " in the street network");
+    }
+    return *it;
+}
+
+void Data::relink_georef() {
+    std::set<const georef::Admin*> admin_copies;
+    std::set<const georef::Way*> way_copies;
+    std::function<void(const georef::Admin*)> add_admin_copy = [&](const georef::Admin* admin) {
+        if (admin_copies.insert(admin).second) {
+            for (const auto* parent : admin->admin_list) {
+                add_admin_copy(parent);
+            }
+        }
+    };
+    auto relink_admins = [&](std::vector<georef::Admin*>& admin_list) {
+        for (auto& admin : admin_list) {
+            add_admin_copy(admin);
+            admin = find_shared_georef_object(geo_ref->admins, *admin);
+        }
+    };
+
+    for (auto* stop_area : pt_data->stop_areas) {
+        relink_admins(stop_area->admin_list);
+    }
+    for (auto* stop_point : pt_data->stop_points) {
+        relink_admins(stop_point->admin_list);
+        if (stop_point->address == nullptr || stop_point->address->way == nullptr) {
+            continue;
+        }
+        const auto* way = stop_point->address->way;
+        if (way_copies.insert(way).second) {
+            for (const auto* admin : way->admin_list) {
+                add_admin_copy(admin);
+            }
+        }
+        stop_point->address->way = find_shared_georef_object(geo_ref->ways, *way);
+    }
+
+    for (const auto* admin : admin_copies) {
+        delete admin;
+    }
+    for (const auto* way : way_copies) {
+        delete way;
+    }
 }
 
 void Data::set_last_rt_data_loaded(const boost::posix_time::ptime& p) const {
@@ -130,7 +130,8 @@ public:
     // public transport (PT) referential
     std::unique_ptr<PT_Data> pt_data;
 
-    std::unique_ptr<navitia::georef::GeoRef> geo_ref;
+    // the street network is never modified by the realtime, it is thus shared between a Data and its clones
+    std::shared_ptr<navitia::georef::GeoRef> geo_ref;
 
     // precomputed data for raptor (public transport routing algorithm)
     std::unique_ptr<navitia::routing::dataRAPTOR> dataRaptor;
@@ -206,6 +207,8 @@ public:
                           int chaos_batch_size,
                           const std::vector<std::string>& contributors = {});
     void build_raptor(size_t cache_size = 10);
+    /// Build raptor after a realtime update of a clone of `previous`, only the modified routes are rebuilt
+    void build_raptor(const Data& previous, size_t cache_size = 10);
 
     void warmup(const Data& other);
 
@@ -221,6 +224,8 @@ public:
 
     /** Build ProximityList index */
     void build_proximity_list();
+    /** Build the landmarks of the street network, for the A* of the direct paths */
+    void build_landmarks(size_t nb_landmarks);
     /** Set admins*/
     void build_administrative_regions();
 
@@ -242,19 +247,28 @@ public:
      *
      * LZ4 compression is super fast but its efficiency is average
      * The goal is to achieve the same read performance with and without compression
+     *
+     * Both the chunked format (see LZ4ParallelCompressor), decompressed on several threads,
+     * and the former sequential format are read. The chunked format is read through its index, at the
+     * end of the file, so it can only be read from a seekable stream.
      */
     void load(std::istream& ifs);
+    /** Same as above, from a buffer holding the whole compressed file */
+    void load(const char* buffer, size_t size);
 
     /** Save data in a compressed binary file using LZ4*/
     void save(std::ostream& ofs) const;
 
-    // Deep clone from the given Data.
+    // Deep clone from the given Data, except for the street network that is shared with it.
     void clone_from(const Data&);
 
     void set_last_rt_data_loaded(const boost::posix_time::ptime&) const;
     const boost::posix_time::ptime last_rt_data_loaded() const;
 
 private:
+    /** After a clone, make the public transport objects point to the shared street network **/
+    void relink_georef();
+
     /** Get similar validitypattern **/
     ValidityPattern* get_similar_validity_pattern(ValidityPattern* vp) const;
 };
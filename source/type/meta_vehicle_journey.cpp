@@ -154,6 +154,11 @@ VJ* MetaVehicleJourney::impl_create_vj(const std::string& uri,
                                        std::vector<StopTime> sts,
                                        nt::PT_Data& pt_data) {
     namespace ndtu = navitia::DateTimeUtils;
+    // the new vj can deactivate (or delete) all the other vjs of the meta vj
+    pt_data.mark_rt_modified_routes(*this);
+    if (route) {
+        pt_data.rt_modified_routes.insert(route->idx);
+    }
     // creating the vj
     auto vj_ptr = std::make_unique<VJ>();
     VJ* ret = vj_ptr.get();
@@ -307,6 +312,9 @@ void MetaVehicleJourney::cancel_vj(RTLevel level,
 
                 if (concerns_base_at_period(*vj, vp_level, periods, vp_modifier)) {
                     vj->validity_patterns[vp_level] = pt_data.get_or_create_validity_pattern(tmp_vp);
+                    if (vj->route) {
+                        pt_data.rt_modified_routes.insert(vj->route->idx);
+                    }
                 }
             }
         }
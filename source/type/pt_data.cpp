@@ -41,6 +41,9 @@ www.navitia.io
 #include "type/network.h"
 #include "type/base_pt_objects.h"
 #include "type/meta_vehicle_journey.h"
+#include "type/route.h"
+#include "type/stop_time_columns.h"
+#include "type/vehicle_journey.h"
 #include "type/multi_polygon_map.h"
 #include "type/commercial_mode.h"
 #include "type/physical_mode.h"
@@ -60,7 +63,10 @@ void PT_Data::serialize(Archive& ar, const unsigned int /*unused*/) {
             ITERATE_NAVITIA_PT_TYPES(SERIALIZE_ELEMENTS)
         & stop_area_autocomplete& stop_point_autocomplete& line_autocomplete& network_autocomplete& mode_autocomplete&
             route_autocomplete& stop_area_proximity_list& stop_point_proximity_list& stop_point_connections&
-                disruption_holder& meta_vjs& stop_points_by_area& comments& codes& headsign_handler& tz_manager;
+                disruption_holder& meta_vjs& stop_points_by_area& comments& codes& headsign_handler& tz_manager&
+                    main_stop_areas_by_admin& odt_stop_points_by_admin;
+    // the stop times are not serialized with their vehicle journey, but all together in flat columns
+    serialize_stop_times(ar, vehicle_journeys, stop_points);
 }
 SERIALIZABLE(PT_Data)
 
@@ -418,6 +424,10 @@ void PT_Data::compute_score_autocomplete(navitia::georef::GeoRef& georef) {
     // use the score of each admin for it's objects like "POI", "way" and "stop_point"
     georef.fl_way.compute_score((*this), georef, type::Type_e::Way);
     georef.fl_poi.compute_score((*this), georef, type::Type_e::POI);
+    compute_pt_score_autocomplete(georef);
+}
+
+void PT_Data::compute_pt_score_autocomplete(navitia::georef::GeoRef& georef) {
     this->stop_point_autocomplete.compute_score((*this), georef, type::Type_e::StopPoint);
     // Compute stop_area score using it's stop_point count
     this->stop_area_autocomplete.compute_score((*this), georef, type::Type_e::StopArea);
@@ -437,6 +447,18 @@ void PT_Data::build_proximity_list() {
     this->stop_point_proximity_list.build();
 }
 
+const std::vector<const StopArea*>& PT_Data::main_stop_areas(const georef::Admin& admin) const {
+    static const std::vector<const StopArea*> empty;
+    const auto it = main_stop_areas_by_admin.find(admin.idx);
+    return it == main_stop_areas_by_admin.end() ? empty : it->second;
+}
+
+const std::vector<const StopPoint*>& PT_Data::odt_stop_points(const georef::Admin& admin) const {
+    static const std::vector<const StopPoint*> empty;
+    const auto it = odt_stop_points_by_admin.find(admin.idx);
+    return it == odt_stop_points_by_admin.end() ? empty : it->second;
+}
+
 void PT_Data::build_admins_stop_areas() {
     for (navitia::type::StopPoint* stop_point : this->stop_points) {
         if (!stop_point->stop_area) {
@@ -511,6 +533,14 @@ Indexes PT_Data::get_impacts_idx(const std::vector<boost::shared_ptr<disruption:
     return result;
 }
 
+void PT_Data::mark_rt_modified_routes(const MetaVehicleJourney& mvj) {
+    mvj.for_all_vjs([&](const VehicleJourney& vj) {
+        if (vj.route) {
+            rt_modified_routes.insert(vj.route->idx);
+        }
+    });
+}
+
 const StopPointConnection* PT_Data::get_stop_point_connection(const StopPoint& from, const StopPoint& to) const {
     const auto& connections = from.stop_point_connection_list;
     auto is_the_one = [&](const type::StopPointConnection* conn) {
@@ -43,6 +43,7 @@ www.navitia.io
 #include "headsign_handler.h"
 #include "type/timezone_manager.h"
 #include <memory>
+#include <set>
 
 namespace navitia {
 template <>
@@ -114,6 +115,22 @@ public:
     // timezone manager
     TimeZoneManager tz_manager;
 
+    // Main stop areas of the admins, by admin idx. They are not stored in georef::Admin so that
+    // the street network never points to public transport objects and can be shared between
+    // the data snapshots
+    std::map<idx_t, std::vector<const StopArea*>> main_stop_areas_by_admin;
+
+    // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
+    // zone odt stop points of the admins, by admin idx
+    std::map<idx_t, std::vector<const StopPoint*>> odt_stop_points_by_admin;
+
+    const std::vector<const StopArea*>& main_stop_areas(const georef::Admin&) const;
+    const std::vector<const StopPoint*>& odt_stop_points(const georef::Admin&) const;
+
+    // Routes whose vehicle journeys have been modified by a disruption since the data have been
+    // loaded or cloned (not serialized), dataRAPTOR only needs to rebuild their journey patterns
+    std::set<idx_t> rt_modified_routes;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
     /** Construit l'indexe ExternelCode */
@@ -124,6 +141,8 @@ public:
 
     /** Calcul le score des objectTC */
     void compute_score_autocomplete(navitia::georef::GeoRef&);
+    /** Only compute the score of the stop areas and stop points, the scores of the georef objects are kept */
+    void compute_pt_score_autocomplete(navitia::georef::GeoRef&);
 
     /** Construit l'indexe ProximityList */
     void build_proximity_list();
@@ -169,6 +188,9 @@ public:
 
     void clean_weak_impacts();
 
+    /// add the routes of all the vehicle journeys of the meta vj to rt_modified_routes
+    void mark_rt_modified_routes(const MetaVehicleJourney& mvj);
+
     Indexes get_impacts_idx(const std::vector<boost::shared_ptr<disruption::Impact>>& impacts) const;
 
     const StopPointConnection* get_stop_point_connection(const StopPoint& from, const StopPoint& to) const;
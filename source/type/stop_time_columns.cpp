@@ -0,0 +1,133 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "type/stop_time_columns.h"
+
+#include "type/data_exceptions.h"
+#include "type/stop_point.h"
+#include "type/stop_time.h"
+#include "type/vehicle_journey.h"
+
+#include <unordered_map>
+
+namespace navitia {
+namespace type {
+
+constexpr uint32_t StopTimeColumns::no_rank;
+
+StopTimeColumns::StopTimeColumns(const std::vector<VehicleJourney*>& vehicle_journeys,
+                                 const std::vector<StopPoint*>& stop_points) {
+    // the idx of the stop points made by hand (in the tests for example) may not be their rank
+    std::unordered_map<const StopPoint*, uint32_t> sp_ranks;
+    for (size_t i = 0; i < stop_points.size(); ++i) {
+        sp_ranks[stop_points[i]] = i;
+    }
+    std::unordered_map<const LineString*, uint32_t> shape_ranks_by_shape;
+
+    size_t nb_stop_times = 0;
+    for (const auto* vj : vehicle_journeys) {
+        nb_stop_times += vj->stop_time_list.size();
+    }
+    vj_offsets.reserve(vehicle_journeys.size() + 1);
+    arrival_times.reserve(nb_stop_times);
+    departure_times.reserve(nb_stop_times);
+    boarding_times.reserve(nb_stop_times);
+    alighting_times.reserve(nb_stop_times);
+    stop_point_ranks.reserve(nb_stop_times);
+    shape_ranks.reserve(nb_stop_times);
+    local_traffic_zones.reserve(nb_stop_times);
+    properties.reserve(nb_stop_times);
+
+    vj_offsets.push_back(0);
+    for (const auto* vj : vehicle_journeys) {
+        for (const auto& st : vj->stop_time_list) {
+            arrival_times.push_back(st.arrival_time);
+            departure_times.push_back(st.departure_time);
+            boarding_times.push_back(st.boarding_time);
+            alighting_times.push_back(st.alighting_time);
+            const auto sp_rank = sp_ranks.find(st.stop_point);
+            stop_point_ranks.push_back(sp_rank == sp_ranks.end() ? no_rank : sp_rank->second);
+            if (st.shape_from_prev) {
+                const auto inserted = shape_ranks_by_shape.emplace(st.shape_from_prev.get(), shapes.size());
+                if (inserted.second) {
+                    shapes.push_back(st.shape_from_prev);
+                }
+                shape_ranks.push_back(inserted.first->second);
+            } else {
+                shape_ranks.push_back(no_rank);
+            }
+            local_traffic_zones.push_back(st.local_traffic_zone);
+            properties.push_back(static_cast<uint8_t>(st.properties.to_ulong()));
+        }
+        vj_offsets.push_back(arrival_times.size());
+    }
+}
+
+void StopTimeColumns::fill(const std::vector<VehicleJourney*>& vehicle_journeys,
+                           const std::vector<StopPoint*>& stop_points) const {
+    const size_t nb_stop_times = arrival_times.size();
+    if (vj_offsets.size() != vehicle_journeys.size() + 1 || vj_offsets.back() != nb_stop_times
+        || departure_times.size() != nb_stop_times || boarding_times.size() != nb_stop_times
+        || alighting_times.size() != nb_stop_times || stop_point_ranks.size() != nb_stop_times
+        || shape_ranks.size() != nb_stop_times || local_traffic_zones.size() != nb_stop_times
+        || properties.size() != nb_stop_times) {
+        throw navitia::data::data_loading_error("the stop times don't match the vehicle journeys");
+    }
+    auto get_or_null = [](const auto& objects, const uint32_t rank) {
+        if (rank == no_rank) {
+            return typename std::decay_t<decltype(objects)>::value_type{};
+        }
+        if (rank >= objects.size()) {
+            throw navitia::data::data_loading_error("a stop time points to an unknown stop point or shape");
+        }
+        return objects[rank];
+    };
+    for (size_t i = 0; i < vehicle_journeys.size(); ++i) {
+        if (vj_offsets[i] > vj_offsets[i + 1]) {
+            throw navitia::data::data_loading_error("the stop times don't match the vehicle journeys");
+        }
+        auto* vj = vehicle_journeys[i];
+        vj->stop_time_list.clear();
+        vj->stop_time_list.reserve(vj_offsets[i + 1] - vj_offsets[i]);
+        for (auto rank = vj_offsets[i]; rank < vj_offsets[i + 1]; ++rank) {
+            StopTime st(arrival_times[rank], departure_times[rank], get_or_null(stop_points, stop_point_ranks[rank]));
+            st.boarding_time = boarding_times[rank];
+            st.alighting_time = alighting_times[rank];
+            st.vehicle_journey = vj;
+            st.shape_from_prev = get_or_null(shapes, shape_ranks[rank]);
+            st.local_traffic_zone = local_traffic_zones[rank];
+            st.properties = properties[rank];
+            vj->stop_time_list.push_back(std::move(st));
+        }
+    }
+}
+
+}  // namespace type
+}  // namespace navitia
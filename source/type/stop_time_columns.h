@@ -0,0 +1,170 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/fwd_type.h"
+#include "type/geographical_coord.h"
+
+#include <boost/endian/conversion.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/serialization/binary_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace navitia {
+namespace type {
+
+/** The stop times of all the vehicle journeys in flat arrays, as they are stored in the .nav
+ *
+ * The stop times of vehicle_journeys[i] are at the ranks [vj_offsets[i], vj_offsets[i + 1]) of
+ * each column. The pointers are replaced by indexes: the stop point by its rank in stop_points,
+ * the shape by its rank in shapes.
+ *
+ * Serialized through the archive, the stop times would be read field by field and object by
+ * object. Each column is instead written as one block of little endian integers, read back with
+ * a single copy.
+ */
+struct StopTimeColumns {
+    static constexpr uint32_t no_rank = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> vj_offsets;
+    std::vector<uint32_t> arrival_times;
+    std::vector<uint32_t> departure_times;
+    std::vector<uint32_t> boarding_times;
+    std::vector<uint32_t> alighting_times;
+    std::vector<uint32_t> stop_point_ranks;
+    std::vector<uint32_t> shape_ranks;
+    std::vector<uint16_t> local_traffic_zones;
+    std::vector<uint8_t> properties;
+    std::vector<boost::shared_ptr<LineString>> shapes;
+
+    StopTimeColumns() = default;
+    StopTimeColumns(const std::vector<VehicleJourney*>& vehicle_journeys, const std::vector<StopPoint*>& stop_points);
+
+    /// rebuild the stop times of the vehicle journeys, in the order they had when the columns were made
+    void fill(const std::vector<VehicleJourney*>& vehicle_journeys, const std::vector<StopPoint*>& stop_points) const;
+
+    template <class Archive>
+    void save(Archive& ar) const {
+        save_column(ar, vj_offsets);
+        save_column(ar, arrival_times);
+        save_column(ar, departure_times);
+        save_column(ar, boarding_times);
+        save_column(ar, alighting_times);
+        save_column(ar, stop_point_ranks);
+        save_column(ar, shape_ranks);
+        save_column(ar, local_traffic_zones);
+        save_column(ar, properties);
+        ar& shapes;
+    }
+
+    template <class Archive>
+    void load(Archive& ar) {
+        load_column(ar, vj_offsets);
+        load_column(ar, arrival_times);
+        load_column(ar, departure_times);
+        load_column(ar, boarding_times);
+        load_column(ar, alighting_times);
+        load_column(ar, stop_point_ranks);
+        load_column(ar, shape_ranks);
+        load_column(ar, local_traffic_zones);
+        load_column(ar, properties);
+        ar& shapes;
+    }
+
+private:
+    template <class Archive, typename T>
+    static void save_column(Archive& ar, const std::vector<T>& column) {
+        static_assert(std::is_unsigned<T>::value, "the columns only hold unsigned integers");
+        const uint64_t size = column.size();
+        ar& size;
+        if (boost::endian::order::native == boost::endian::order::little) {
+            ar& boost::serialization::make_binary_object(const_cast<T*>(column.data()), size * sizeof(T));
+        } else {
+            auto little = column;
+            for (auto& value : little) {
+                boost::endian::native_to_little_inplace(value);
+            }
+            ar& boost::serialization::make_binary_object(little.data(), size * sizeof(T));
+        }
+    }
+
+    template <class Archive, typename T>
+    static void load_column(Archive& ar, std::vector<T>& column) {
+        uint64_t size = 0;
+        ar& size;
+        column.resize(size);
+        ar& boost::serialization::make_binary_object(column.data(), size * sizeof(T));
+        if (boost::endian::order::native != boost::endian::order::little) {
+            for (auto& value : column) {
+                boost::endian::little_to_native_inplace(value);
+            }
+        }
+    }
+};
+
+/** Serialize the stop times of all the vehicle journeys as StopTimeColumns
+ *
+ * On loading, the vehicle journeys and the stop points must already be loaded
+ */
+template <class Archive>
+void serialize_stop_times(Archive& ar,
+                          const std::vector<VehicleJourney*>& vehicle_journeys,
+                          const std::vector<StopPoint*>& stop_points,
+                          boost::mpl::true_ /*is_saving*/) {
+    StopTimeColumns(vehicle_journeys, stop_points).save(ar);
+}
+
+template <class Archive>
+void serialize_stop_times(Archive& ar,
+                          const std::vector<VehicleJourney*>& vehicle_journeys,
+                          const std::vector<StopPoint*>& stop_points,
+                          boost::mpl::false_ /*is_saving*/) {
+    StopTimeColumns columns;
+    columns.load(ar);
+    columns.fill(vehicle_journeys, stop_points);
+}
+
+template <class Archive>
+void serialize_stop_times(Archive& ar,
+                          const std::vector<VehicleJourney*>& vehicle_journeys,
+                          const std::vector<StopPoint*>& stop_points) {
+    serialize_stop_times(ar, vehicle_journeys, stop_points, typename Archive::is_saving());
+}
+
+}  // namespace type
+}  // namespace navitia
@@ -36,12 +36,17 @@ www.navitia.io
 #include <boost/filesystem.hpp>
 
 // Std
+#include <sstream>
 #include <string>
 
+#include "ed/build_helper.h"
 #include "utils/functions.h"  // absolute_path function
 
 // Data to test
 #include "type/data.h"
+#include "type/pt_data.h"
+#include "type/stop_point.h"
+#include "type/vehicle_journey.h"
 
 using namespace navitia;
 
@@ -75,6 +80,69 @@ BOOST_AUTO_TEST_CASE(load_data) {
     boost::filesystem::remove(fake_data_path);
 }
 
+// stream buffer that can't be seeked, as the one of a pipe
+struct NonSeekableBuf : std::streambuf {
+    std::string data;
+    explicit NonSeekableBuf(std::string content) : data(std::move(content)) {
+        setg(&data[0], &data[0], &data[0] + data.size());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(load_data_from_a_stream) {
+    navitia::type::Data data(0);
+    std::stringstream saved;
+    data.save(saved);
+
+    navitia::type::Data loaded(0);
+    BOOST_CHECK_NO_THROW(loaded.load(saved));
+
+    // the index of the chunked format, at the end of the file, can't be reached
+    NonSeekableBuf buf(saved.str());
+    std::istream pipe(&buf);
+    BOOST_CHECK_THROW(loaded.load(pipe), navitia::data::data_loading_error);
+}
+
+BOOST_AUTO_TEST_CASE(save_and_load_the_stop_times) {
+    ed::builder b("20120614", [](ed::builder& b) {
+        b.vj("A")("stop1", 8000, 8050)("stop2", 8200, 8250, 3, true, false, 10, 20)
+            .st_shape({{1., 1.}, {2., 2.}})("stop3", 8400);
+        b.vj("B")("stop3", 9000)("stop1", 9100, 9150, std::numeric_limits<uint16_t>::max(), false, true)
+            .st_shape({{3., 3.}, {1., 1.}});
+    });
+    std::stringstream saved;
+    b.data->save(saved);
+
+    navitia::type::Data loaded(0);
+    loaded.load(saved);
+
+    const auto& vjs = b.data->pt_data->vehicle_journeys;
+    const auto& loaded_vjs = loaded.pt_data->vehicle_journeys;
+    BOOST_REQUIRE_EQUAL(loaded_vjs.size(), vjs.size());
+    for (size_t i = 0; i < vjs.size(); ++i) {
+        BOOST_CHECK_EQUAL(loaded_vjs[i]->uri, vjs[i]->uri);
+        BOOST_REQUIRE_EQUAL(loaded_vjs[i]->stop_time_list.size(), vjs[i]->stop_time_list.size());
+        for (size_t j = 0; j < vjs[i]->stop_time_list.size(); ++j) {
+            const auto& st = vjs[i]->stop_time_list[j];
+            const auto& loaded_st = loaded_vjs[i]->stop_time_list[j];
+            BOOST_CHECK_EQUAL(loaded_st.arrival_time, st.arrival_time);
+            BOOST_CHECK_EQUAL(loaded_st.departure_time, st.departure_time);
+            BOOST_CHECK_EQUAL(loaded_st.boarding_time, st.boarding_time);
+            BOOST_CHECK_EQUAL(loaded_st.alighting_time, st.alighting_time);
+            BOOST_CHECK_EQUAL(loaded_st.local_traffic_zone, st.local_traffic_zone);
+            BOOST_CHECK_EQUAL(loaded_st.properties, st.properties);
+            BOOST_CHECK_EQUAL(loaded_st.stop_point->uri, st.stop_point->uri);
+            BOOST_CHECK_EQUAL(loaded_st.vehicle_journey, loaded_vjs[i]);
+            BOOST_CHECK_EQUAL(bool(loaded_st.shape_from_prev), bool(st.shape_from_prev));
+            if (st.shape_from_prev) {
+                BOOST_CHECK(*loaded_st.shape_from_prev == *st.shape_from_prev);
+            }
+        }
+    }
+    // the stop times point to the loaded stop points
+    const auto* loaded_sp = loaded_vjs[0]->stop_time_list[0].stop_point;
+    BOOST_CHECK_EQUAL(loaded.pt_data->stop_points_map.at(loaded_sp->uri), loaded_sp);
+}
+
 BOOST_AUTO_TEST_CASE(load_disruptions_fail) {
     navitia::type::Data data(0);
 